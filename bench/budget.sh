@@ -0,0 +1,106 @@
+#!/bin/sh
+# Runs every entry of budget.txt under zkrun and compares instructions, host
+# calls and output.wasm size against the recorded values.
+#
+# usage: budget.sh <zkrun> check <threshold percent>
+#        budget.sh <zkrun> update
+
+ZKRUN=$1
+MODE=$2
+THRESHOLD=${3:-0}
+BUDGET=budget.txt
+
+if [ $# -lt 2 ] || { [ "$MODE" != check ] && [ "$MODE" != update ]; }; then
+    echo "usage: $0 <zkrun> check <threshold percent> | $0 <zkrun> update"
+    exit 1
+fi
+
+# prints "<instructions> <host calls>" for one entry
+measure() {
+    image=$1
+    shift
+    inputs=
+    for arg in "$@"; do
+        case $arg in
+        @*)
+            data=$(cat ${arg#@})
+            inputs="$inputs --public $(( (${#data} - 2) / 2 )):i64 --private $data:bytes-packed"
+            ;;
+        *)
+            inputs="$inputs $arg"
+            ;;
+        esac
+    done
+    $ZKRUN $image $inputs > budget.out || {
+        cat budget.out >&2
+        return 1
+    }
+    awk '/^instructions:/ { i = $2 } /^host_calls:/ { h = $2 } END { print i, h }' budget.out
+}
+
+# prints the status of one metric and returns 1 when it is over budget
+compare() {
+    awk -v name=$1 -v metric=$2 -v budget=$3 -v value=$4 -v threshold=$THRESHOLD 'BEGIN {
+        if (budget == "-") {
+            printf "%-26s %-13s %12s %12d %8s  unrecorded\n", name, metric, "-", value, "-"
+            exit 0
+        }
+        delta = budget ? 100 * (value - budget) / budget : (value ? 100 : 0)
+        status = delta > threshold ? "OVER" : "ok"
+        printf "%-26s %-13s %12d %12d %+7.2f%%  %s\n", name, metric, budget, value, delta, status
+        exit status == "OVER"
+    }'
+}
+
+failed=0
+unrecorded=0
+: > budget.new
+[ $MODE = check ] && printf "%-26s %-13s %12s %12s %8s  %s\n" benchmark metric budget measured delta status
+while IFS= read -r line; do
+    case $line in
+    ''|'#'*)
+        echo "$line" >> budget.new
+        continue
+        ;;
+    esac
+    set -- $line
+    name=$1
+    dir=$2
+    instructions=$3
+    host_calls=$4
+    wasm_bytes=$5
+    shift 5
+
+    image=$dir/output.wasm
+    size=$(wc -c < $image) || exit 1
+    measured=$(measure $image "$@") || {
+        echo "$name: zkrun failed" >&2
+        exit 1
+    }
+    set -- $measured
+
+    if [ $MODE = check ]; then
+        compare $name instructions $instructions $1 || failed=1
+        compare $name host_calls $host_calls $2 || failed=1
+        compare $name wasm_bytes $wasm_bytes $size || failed=1
+        [ "$instructions" = - ] || [ "$host_calls" = - ] || [ "$wasm_bytes" = - ] && unrecorded=1
+    fi
+    # same line with the three recorded values replaced
+    echo "$line" | awk -v i=$1 -v h=$2 -v s=$size '{ $3 = i; $4 = h; $5 = s; print }' >> budget.new
+done < $BUDGET
+rm -f budget.out
+
+if [ $MODE = update ]; then
+    mv budget.new $BUDGET
+    echo "updated $BUDGET"
+    exit 0
+fi
+rm -f budget.new
+if [ $failed -ne 0 ]; then
+    echo "performance budget exceeded by more than $THRESHOLD%"
+fi
+# an entry without recorded values guards nothing, so it fails the gate too
+if [ $unrecorded -ne 0 ]; then
+    echo "some entries have no recorded budget, run make budget-update and commit budget.txt"
+fi
+[ $failed -eq 0 ] && [ $unrecorded -eq 0 ]
@@ -0,0 +1,51 @@
+#!/bin/sh
+# Sweeps keccak256, the sha3_* wrappers and the chunked Keccak_Absorb path over message
+# lengths (SHAKE128 over output lengths) and prints the cost of each run above
+# the fill-only baseline, per Keccak-f[1600] permutation, together with the
+# extra stack taken.
+#
+# usage: run.sh <zkrun> <image.wasm>
+
+ZKRUN=$1
+IMAGE=$2
+SIZES="0 1 32 71 72 103 104 135 136 137 143 144 200 512 1024 4096 16384 32768"
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 <zkrun> <image.wasm>"
+    exit 1
+fi
+
+# prints "<instructions> <stack bytes>"
+measure() {
+    $ZKRUN $IMAGE --public $1:i64 --public $2:i64 > run.out || {
+        cat run.out
+        exit 1
+    }
+    awk '/^instructions:/ { i = $2 } /^stack_bytes:/ { s = $2 } END { print i, s + 0 }' run.out
+}
+
+printf "%-9s %6s %13s %6s %11s %11s\n" function size instructions perms instr/perm stack_bytes
+# mode, name and rate in bytes of each preset
+for preset in "6 keccak256 136" "1 sha3_224 144" "2 sha3_256 136" "3 sha3_384 104" "4 sha3_512 72" "5 absorb61 136" "7 shake128 168"; do
+    set -- $preset
+    mode=$1
+    name=$2
+    rate=$3
+    for size in $SIZES; do
+        # squeezing no output never finalizes the sponge, there is no permutation to count
+        [ $name = shake128 ] && [ $size -eq 0 ] && continue
+        set -- $(measure 0 $size)
+        base=$1
+        base_stack=$2
+        set -- $(measure $mode $size)
+        awk -v name=$name -v size=$size -v rate=$rate -v total=$1 -v base=$base -v stack=$2 -v base_stack=$base_stack 'BEGIN {
+            cost = total - base
+            # the message plus one block of padding
+            perms = int(size / rate) + 1
+            # shake128: the seed block yields the first block of output, then one per block
+            if (name == "shake128") perms = int((size + rate - 1) / rate)
+            printf "%-9s %6d %13d %6d %11.1f %11d\n", name, size, cost, perms, cost / perms, stack - base_stack
+        }'
+    done
+done
+rm -f run.out
@@ -0,0 +1,240 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "zkwasmsdk.h"
+#include "hash-wasm.h"
+#include "hmac.h"
+#include "rlp.h"
+#include "zkwasm-native.h"
+
+/*
+ * Host-side microbenchmarks of the sdk routines, linked against the native
+ * build in sdk/native. Every case is timed in batches long enough for the
+ * clock (at least MIN_BATCH_NS), and the per-call times of SAMPLES batches
+ * are summarized as mean, median, standard deviation and minimum.
+ */
+
+#define SAMPLES 31
+#define MIN_BATCH_NS 2000000.0
+#define MAX_MESSAGE 65536
+#define MAX_CORPUS 65536
+
+static uint8_t msg[MAX_MESSAGE + 8] __attribute__((aligned(8)));
+static uint8_t digest[64];
+static uint8_t digests[MAX_MESSAGE];
+static uint8_t corpus[MAX_CORPUS];
+static struct rlpItemAllocator itemAllocator;
+/* keeps the optimizer from dropping the measured calls */
+static volatile uint32_t sink;
+
+struct bench_case {
+    const char *name;
+    void (*fn)(uint32_t size);
+    uint32_t size;
+};
+
+static void sha256_digest(uint32_t size) {
+    SHA256_Digest(digest, size, msg);
+    sink += digest[0];
+}
+
+static void sha256_update61(uint32_t size) {
+    Hash_Init(256);
+    for (uint32_t pos = 0; pos < size; pos += 61)
+        Hash_Update(size - pos < 61 ? size - pos : 61, msg + pos);
+    Hash_Final(digest);
+    sink += digest[0];
+}
+
+static void sha256_hash64(uint32_t size) {
+    uint32_t node[8];
+    for (uint32_t done = 0; done + 64 <= size; done += 64)
+        SHA256_Hash64(node, (const uint32_t *)(msg + done), (const uint32_t *)(msg + done + 32));
+    sink += node[0];
+}
+
+static void sha256_input(uint32_t size) {
+    zkwasm_native_rewind();
+    SHA256_DigestInput(digest, size, 0, NULL);
+    sink += digest[0];
+}
+
+static void sha256_staged(uint32_t size) {
+    zkwasm_native_rewind();
+    read_bytes_from_u64(msg, size, 0);
+    SHA256_Digest(digest, size, msg);
+    sink += digest[0];
+}
+
+/* size bytes as 64-byte messages, one batch against one digest each */
+static void sha256_batch64(uint32_t size) {
+    SHA256_DigestBatch(digests, msg, size / 64, 64);
+    sink += digests[0];
+}
+
+static void sha256_each64(uint32_t size) {
+    for (uint32_t i = 0; i < size / 64; i++) SHA256_Digest(digests + 32 * i, 64, msg + 64 * i);
+    sink += digests[0];
+}
+
+static void sha512_digest(uint32_t size) {
+    SHA512_Digest(digest, size, msg);
+    sink += digest[0];
+}
+
+/* size bytes as 64-byte messages under one key */
+static void hmac_sha256_64(uint32_t size) {
+    static struct hmac_sha256_key key;
+    if (!key.inner.length) HMAC_SHA256_SetKey(&key, 32, corpus);
+    for (uint32_t i = 0; i < size / 64; i++) HMAC_SHA256(digests + 32 * i, &key, 64, msg + 64 * i);
+    sink += digests[0];
+}
+
+static void keccak256_digest(uint32_t size) {
+    keccak256(msg, size, digest);
+    sink += digest[0];
+}
+
+static void sha3_256_digest(uint32_t size) {
+    sha3_256(msg, size, digest);
+    sink += digest[0];
+}
+
+static void sha3_512_digest(uint32_t size) {
+    sha3_512(msg, size, digest);
+    sink += digest[0];
+}
+
+/* size bytes of SHAKE128 output from a 32-byte seed, 8 bytes at a time */
+static void shake128_out(uint32_t size) {
+    struct keccak_ctx ctx;
+    SHAKE128_Init(&ctx);
+    Keccak_Absorb(&ctx, 32, msg);
+    for (uint32_t done = 0; done < size; done += 8) Keccak_Squeeze(&ctx, 8, digest);
+    sink += digest[0];
+}
+
+static void rlp_decode(uint32_t size) {
+    itemAllocator.pos = 0;
+    decode(corpus, 0, &itemAllocator);
+    sink += itemAllocator.pos;
+}
+
+/* wasm_input() stand-in plus read_bytes_from_u64, the input path of every zkmain */
+static void input_read(uint32_t size) {
+    zkwasm_native_rewind();
+    read_bytes_from_u64(msg, size, 0);
+    sink += msg[0];
+}
+
+static struct bench_case cases[] = {
+    { "sha256_digest", sha256_digest, 64 },
+    { "sha256_digest", sha256_digest, 1024 },
+    { "sha256_digest", sha256_digest, 65536 },
+    { "sha256_update61", sha256_update61, 1024 },
+    { "sha256_hash64", sha256_hash64, 1024 },
+    { "sha256_input", sha256_input, 4096 },
+    { "sha256_staged", sha256_staged, 4096 },
+    { "sha256_batch64", sha256_batch64, 4096 },
+    { "sha256_each64", sha256_each64, 4096 },
+    { "hmac_sha256_64", hmac_sha256_64, 4096 },
+    { "sha512_digest", sha512_digest, 1024 },
+    { "sha512_digest", sha512_digest, 65536 },
+    { "keccak256", keccak256_digest, 1024 },
+    { "sha3_256", sha3_256_digest, 136 },
+    { "sha3_256", sha3_256_digest, 1024 },
+    { "sha3_256", sha3_256_digest, 32768 },
+    { "sha3_512", sha3_512_digest, 1024 },
+    { "shake128_out", shake128_out, 4096 },
+    { "input_read", input_read, 4096 },
+    { "rlp_decode", rlp_decode, 0 },
+};
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int by_value(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void run(struct bench_case *c) {
+    double samples[SAMPLES], sum = 0, var = 0;
+    uint64_t batch = 1;
+
+    /* grow the batch until it is long enough to time */
+    for (;;) {
+        double start = now_ns();
+        for (uint64_t i = 0; i < batch; i++) c->fn(c->size);
+        if (now_ns() - start >= MIN_BATCH_NS) break;
+        batch *= 2;
+    }
+    for (int s = 0; s < SAMPLES; s++) {
+        double start = now_ns();
+        for (uint64_t i = 0; i < batch; i++) c->fn(c->size);
+        samples[s] = (now_ns() - start) / batch;
+        sum += samples[s];
+    }
+    double mean = sum / SAMPLES;
+    for (int s = 0; s < SAMPLES; s++) var += (samples[s] - mean) * (samples[s] - mean);
+    qsort(samples, SAMPLES, sizeof(double), by_value);
+    double median = samples[SAMPLES / 2];
+
+    printf("%-16s %6u %12.1f %12.1f %10.1f %12.1f", c->name, c->size, mean, median, sqrt(var / (SAMPLES - 1)), samples[0]);
+    if (c->size) printf(" %10.1f", c->size * 1e3 / median);
+    printf("\n");
+}
+
+static int hex_nibble(int c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/* Loads a bench/rlp corpus file: one hex string with a 0x prefix */
+static uint32_t load_corpus(const char *path) {
+    FILE *f = fopen(path, "r");
+    uint32_t len = 0;
+    int c, hi = -1;
+    if (!f) {
+        fprintf(stderr, "bench: cannot read %s\n", path);
+        exit(1);
+    }
+    if (fgetc(f) != '0' || fgetc(f) != 'x') rewind(f);
+    while ((c = fgetc(f)) != EOF && hex_nibble(c) >= 0 && len < MAX_CORPUS) {
+        if (hi < 0) {
+            hi = hex_nibble(c);
+        } else {
+            corpus[len++] = hi << 4 | hex_nibble(c);
+            hi = -1;
+        }
+    }
+    fclose(f);
+    return len;
+}
+
+/*
+ * usage: bench [rlp corpus file]
+ * Times are nanoseconds per call; MB/s is derived from the median.
+ */
+int main(int argc, char **argv) {
+    for (uint32_t i = 0; i < sizeof(msg); i++) msg[i] = (uint8_t)(i * 131 + 7);
+    zkwasm_native_input_bytes(0, msg, 4096);
+
+    printf("%-16s %6s %12s %12s %10s %12s %10s\n", "case", "bytes", "mean ns", "median ns", "stddev", "min ns", "MB/s");
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (cases[i].fn == rlp_decode) {
+            if (argc < 2) continue;
+            cases[i].size = load_corpus(argv[1]);
+        }
+        run(&cases[i]);
+    }
+    zkwasm_native_reset();
+    return 0;
+}
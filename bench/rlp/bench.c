@@ -0,0 +1,47 @@
+#include "zkwasmsdk.h"
+#include "hash-wasm.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "rlp.h"
+
+#define MODE_BASELINE 0
+#define MODE_ITEMS 1
+#define MODE_DEPTH 2
+
+#define MAX_INPUT 65536
+
+alignas(8) uint8_t buf[MAX_INPUT];
+struct rlpItemAllocator itemAllocator;
+
+/* Nesting depth of the decoded tree, equal to the recursion depth of decode() */
+static int depth(struct rlpItem *item) {
+    if (item->isString) return 1;
+    int deepest = 0;
+    struct rlpItem *child = item->firstChild;
+    for (int i = 0; i < item->len; i++) {
+        int d = depth(child);
+        if (d > deepest) deepest = d;
+        child = child->next;
+    }
+    return deepest + 1;
+}
+
+/*
+ * Public inputs: mode and payload length, payload as private input.
+ * MODE_ITEMS returns the allocator high-water mark after decode(), MODE_DEPTH
+ * walks the result and returns its depth. MODE_BASELINE only reads the input
+ * so that the driver can subtract it from the decoding cost.
+ */
+__attribute__((visibility("default")))
+int zkmain() {
+    uint32_t mode = (uint32_t)wasm_input(1);
+    uint32_t length = (uint32_t)wasm_input(1);
+    require(length <= MAX_INPUT);
+    read_bytes_from_u64(buf, length, 0);
+
+    if (mode == MODE_BASELINE) return 0;
+
+    struct rlpItem *root = decode(buf, 0, &itemAllocator);
+    if (mode == MODE_ITEMS) return itemAllocator.pos;
+    return depth(root);
+}
@@ -0,0 +1,169 @@
+/*
+ * Generates the synthetic part of the RLP benchmark corpus: receipts with a
+ * growing number of logs, legacy transactions with growing call data and
+ * block bodies with a growing number of transactions. The output is
+ * deterministic, one "0x<hex>" line per file like tests/rlp/test_data.txt.
+ *
+ * usage: gen <output directory>
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct buf {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+};
+
+static uint64_t seed = 0x9e3779b97f4a7c15ULL;
+
+static uint8_t next_byte(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return (uint8_t)seed;
+}
+
+static void put(struct buf *b, const uint8_t *data, size_t len) {
+    if (b->len + len > b->cap) {
+        b->cap = (b->len + len) * 2;
+        b->data = realloc(b->data, b->cap);
+        if (!b->data) exit(1);
+    }
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+}
+
+static void put_header(struct buf *b, uint8_t short_base, size_t len) {
+    uint8_t header[9];
+    if (len <= 55) {
+        header[0] = short_base + len;
+        put(b, header, 1);
+        return;
+    }
+    int n = 0;
+    for (size_t l = len; l; l >>= 8) n++;
+    header[0] = short_base + 55 + n;
+    for (int i = 0; i < n; i++) header[n - i] = (uint8_t)(len >> (8 * i));
+    put(b, header, n + 1);
+}
+
+static void put_string(struct buf *b, const uint8_t *data, size_t len) {
+    if (len == 1 && data[0] < 0x80) {
+        put(b, data, 1);
+        return;
+    }
+    put_header(b, 0x80, len);
+    put(b, data, len);
+}
+
+static void put_random(struct buf *b, size_t len) {
+    uint8_t *data = malloc(len ? len : 1);
+    for (size_t i = 0; i < len; i++) data[i] = next_byte();
+    put_string(b, data, len);
+    free(data);
+}
+
+static void put_uint(struct buf *b, uint64_t v) {
+    uint8_t data[8];
+    int n = 0;
+    for (uint64_t x = v; x; x >>= 8) n++;
+    for (int i = 0; i < n; i++) data[n - 1 - i] = (uint8_t)(v >> (8 * i));
+    put_string(b, data, n);
+}
+
+/* Wraps the payload of `inner` into a list appended to `b` */
+static void put_list(struct buf *b, struct buf *inner) {
+    put_header(b, 0xc0, inner->len);
+    put(b, inner->data, inner->len);
+    free(inner->data);
+    memset(inner, 0, sizeof(*inner));
+}
+
+static void put_log(struct buf *b, int topics, size_t data_len) {
+    struct buf log = { 0 }, topic_list = { 0 };
+    put_random(&log, 20);
+    for (int i = 0; i < topics; i++) put_random(&topic_list, 32);
+    put_list(&log, &topic_list);
+    put_random(&log, data_len);
+    put_list(b, &log);
+}
+
+static void put_receipt(struct buf *b, int logs) {
+    struct buf receipt = { 0 }, log_list = { 0 };
+    put_uint(&receipt, 1);
+    put_uint(&receipt, 21000 + 30000 * logs);
+    put_random(&receipt, 256);
+    for (int i = 0; i < logs; i++) put_log(&log_list, 3, 64);
+    put_list(&receipt, &log_list);
+    put_list(b, &receipt);
+}
+
+static void put_transaction(struct buf *b, uint64_t nonce, size_t data_len) {
+    struct buf tx = { 0 };
+    put_uint(&tx, nonce);
+    put_uint(&tx, 20000000000ULL);
+    put_uint(&tx, 21000 + 16 * data_len);
+    put_random(&tx, 20);
+    put_uint(&tx, 1000000000000000000ULL);
+    put_random(&tx, data_len);
+    put_uint(&tx, 37);
+    put_random(&tx, 32);
+    put_random(&tx, 32);
+    put_list(b, &tx);
+}
+
+static void put_block_body(struct buf *b, int txs) {
+    struct buf body = { 0 }, tx_list = { 0 }, uncles = { 0 };
+    for (int i = 0; i < txs; i++) put_transaction(&tx_list, i, 100);
+    put_list(&body, &tx_list);
+    put_list(&body, &uncles);
+    put_list(b, &body);
+}
+
+static void write_hex(const char *dir, const char *name, struct buf *b) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s.txt", dir, name);
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "gen: cannot write %s\n", path);
+        exit(1);
+    }
+    fputs("0x", f);
+    for (size_t i = 0; i < b->len; i++) fprintf(f, "%02x", b->data[i]);
+    fputc('\n', f);
+    fclose(f);
+    free(b->data);
+    memset(b, 0, sizeof(*b));
+}
+
+int main(int argc, char **argv) {
+    static const int logs[] = { 4, 16, 64 };
+    static const size_t data[] = { 0, 256, 4096 };
+    static const int txs[] = { 8, 32, 96 };
+    struct buf b = { 0 };
+    char name[64];
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: gen <output directory>\n");
+        return 1;
+    }
+    for (int i = 0; i < 3; i++) {
+        put_receipt(&b, logs[i]);
+        snprintf(name, sizeof(name), "receipt_logs%d", logs[i]);
+        write_hex(argv[1], name, &b);
+    }
+    for (int i = 0; i < 3; i++) {
+        put_transaction(&b, 7, data[i]);
+        snprintf(name, sizeof(name), "tx_data%zu", data[i]);
+        write_hex(argv[1], name, &b);
+    }
+    for (int i = 0; i < 3; i++) {
+        put_block_body(&b, txs[i]);
+        snprintf(name, sizeof(name), "body_txs%d", txs[i]);
+        write_hex(argv[1], name, &b);
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+#!/bin/sh
+# Decodes every payload of the corpus and prints the decoding cost above the
+# input-reading baseline, per decoded item, together with the peak
+# rlpItemAllocator.pos and the recursion depth of decode().
+#
+# usage: run.sh <zkrun> <image.wasm> <corpus file>...
+
+ZKRUN=$1
+IMAGE=$2
+# capacity of struct rlpItemAllocator
+CAPACITY=1024
+
+if [ $# -lt 3 ]; then
+    echo "usage: $0 <zkrun> <image.wasm> <corpus file>..."
+    exit 1
+fi
+shift 2
+
+# prints "<instructions> <stack bytes> <result>"
+measure() {
+    $ZKRUN $IMAGE --public $1:i64 --public $2:i64 --private $3:bytes-packed > run.out || {
+        cat run.out
+        exit 1
+    }
+    awk '/^instructions:/ { i = $2 } /^stack_bytes:/ { s = $2 } /^result:/ { r = $2 } END { print i, s + 0, r }' run.out
+}
+
+printf "%-20s %6s %6s %9s %6s %13s %10s %11s\n" payload bytes items allocator depth instructions instr/item stack_bytes
+for file in "$@"; do
+    data=$(cat $file)
+    length=$(( (${#data} - 2) / 2 ))
+    set -- $(measure 0 $length $data)
+    base=$1
+    base_stack=$2
+    set -- $(measure 1 $length $data)
+    total=$1
+    stack=$2
+    items=$3
+    set -- $(measure 2 $length $data)
+    depth=$3
+    awk -v name=$(basename $file .txt) -v bytes=$length -v items=$items -v capacity=$CAPACITY -v depth=$depth \
+        -v total=$total -v base=$base -v stack=$stack -v base_stack=$base_stack 'BEGIN {
+        cost = total - base
+        printf "%-20s %6d %6d %8.1f%% %6d %13d %10.1f %11d\n", name, bytes, items, 100 * items / capacity,
+            depth, cost, items ? cost / items : 0, stack - base_stack
+    }'
+done
+rm -f run.out
@@ -0,0 +1,108 @@
+#include "zkwasmsdk.h"
+#include "hash-wasm.h"
+#include "merkle.h"
+#include "hmac.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define MODE_BASELINE 0
+#define MODE_DIGEST 1
+#define MODE_UPDATE 2
+#define MODE_HASH64 3
+#define MODE_INPUT 4
+#define MODE_STAGED 5
+#define MODE_BATCH 6
+#define MODE_SEPARATE 7
+#define MODE_MERKLE 8
+#define MODE_HMAC 9
+#define MODE_SHA512 10
+
+#define MAX_MESSAGE 65536
+
+/* Room for the largest message at any of the four byte offsets */
+alignas(8) uint8_t msg[MAX_MESSAGE + 8];
+/* One digest per chunk in MODE_BATCH and MODE_SEPARATE */
+uint8_t digests[MAX_MESSAGE];
+
+/*
+ * Public inputs: mode, message size, source offset (0 = word aligned),
+ * Hash_Update chunk size. MODE_HASH64 folds the message as size / 64 Merkle
+ * node hashes with SHA256_Hash64. MODE_INPUT hashes size bytes of private
+ * input with SHA256_DigestInput, MODE_STAGED reads them with
+ * read_bytes_from_u64 and hashes the buffer. MODE_BATCH hashes the message
+ * as size / chunk messages of chunk bytes with SHA256_DigestBatch,
+ * MODE_SEPARATE hashes the same messages with one SHA256_Digest each.
+ * MODE_MERKLE computes the root of size / 32 leaves in place. MODE_HMAC
+ * authenticates the size / chunk messages of MODE_BATCH under one key.
+ * MODE_SHA512 is MODE_DIGEST with SHA512_Digest. MODE_BASELINE only fills
+ * the message so that the driver can subtract the set-up cost from the
+ * other modes.
+ */
+__attribute__((visibility("default")))
+int zkmain() {
+    uint32_t mode = (uint32_t)wasm_input(1);
+    uint32_t size = (uint32_t)wasm_input(1);
+    uint32_t offset = (uint32_t)wasm_input(1);
+    uint32_t chunk = (uint32_t)wasm_input(1);
+    uint8_t hash[64];
+
+    require(size <= MAX_MESSAGE && offset < 8 && chunk > 0);
+
+    if (mode == MODE_INPUT) {
+        SHA256_DigestInput(hash, size, 0, NULL);
+        return hash[0];
+    }
+    if (mode == MODE_STAGED) {
+        read_bytes_from_u64(msg, size, 0);
+        SHA256_Digest(hash, size, msg);
+        return hash[0];
+    }
+
+    uint64_t *msg64 = (uint64_t *)msg;
+    for (uint32_t i = 0; i < (size + offset + 7) / 8; i++) {
+        msg64[i] = 0x0123456789abcdefULL * (i + 1);
+    }
+
+    const uint8_t *src = msg + offset;
+    if (mode == MODE_DIGEST) {
+        SHA256_Digest(hash, size, src);
+    } else if (mode == MODE_SHA512) {
+        SHA512_Digest(hash, size, src);
+    } else if (mode == MODE_UPDATE) {
+        Hash_Init(256);
+        for (uint32_t done = 0; done < size; done += chunk) {
+            Hash_Update(size - done < chunk ? size - done : chunk, src + done);
+        }
+        Hash_Final(hash);
+    } else if (mode == MODE_HASH64) {
+        uint32_t node[8] = { 0 };
+        require(offset % 4 == 0);
+        for (uint32_t done = 0; done + 64 <= size; done += 64) {
+            SHA256_Hash64(node, (const uint32_t *)(src + done), (const uint32_t *)(src + done + 32));
+        }
+        return (uint8_t)node[0];
+    } else if (mode == MODE_BATCH || mode == MODE_SEPARATE) {
+        uint32_t count = size / chunk;
+        require(count * 32 <= sizeof(digests));
+        if (mode == MODE_BATCH) {
+            SHA256_DigestBatch(digests, src, count, chunk);
+        } else {
+            for (uint32_t i = 0; i < count; i++) SHA256_Digest(digests + 32 * i, chunk, src + chunk * i);
+        }
+        return digests[0];
+    } else if (mode == MODE_HMAC) {
+        struct hmac_sha256_key key;
+        uint32_t count = size / chunk;
+        require(count * 32 <= sizeof(digests));
+        HMAC_SHA256_SetKey(&key, 32, msg + MAX_MESSAGE - 32);
+        for (uint32_t i = 0; i < count; i++) HMAC_SHA256(digests + 32 * i, &key, chunk, src + chunk * i);
+        return digests[0];
+    } else if (mode == MODE_MERKLE) {
+        require(offset % 4 == 0 && size >= 32);
+        SHA256_MerkleRoot((uint32_t *)src, size / 32);
+        return src[0];
+    } else {
+        return 0;
+    }
+    return hash[0];
+}
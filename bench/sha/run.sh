@@ -0,0 +1,78 @@
+#!/bin/sh
+# Sweeps SHA256_Digest, chunked Hash_Update, SHA256_Hash64 and SHA512_Digest over message sizes and source
+# alignments and prints the cost of each run above the fill-only baseline.
+# SHA256_DigestBatch and separate SHA256_Digest calls are compared on
+# BATCH_MESSAGE-byte messages, and SHA256_MerkleRoot runs over 32-byte leaves.
+#
+# usage: run.sh <zkrun> <image.wasm>
+
+ZKRUN=$1
+IMAGE=$2
+SIZES="0 1 32 55 56 63 64 65 100 128 512 1024 4096 16384 65536"
+OFFSETS="0 1"
+# odd chunk size so that most Hash_Update calls start on a partial block
+CHUNK=61
+BATCH_MESSAGE=64
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 <zkrun> <image.wasm>"
+    exit 1
+fi
+
+# prints "<instructions> <zkwasm_sha256_*/zkwasm_sha512_* calls>"
+measure() {
+    $ZKRUN $IMAGE --public $1:i64 --public $2:i64 --public $3:i64 --public $4:i64 > run.out || {
+        cat run.out
+        exit 1
+    }
+    awk '/^instructions:/ { i = $2 } /^host\.zkwasm_sha(256|512)_/ { h += $2 } END { print i, h + 0 }' run.out
+}
+
+printf "%-8s %7s %6s %13s %11s %11s %11s\n" mode size align instructions instr/byte sha256_calls calls/block
+for offset in $OFFSETS; do
+    for size in $SIZES; do
+        base=$(measure 0 $size $offset $CHUNK | cut -d' ' -f1)
+        modes="1 2 10"
+        # SHA256_Hash64 takes word aligned children
+        [ $offset -eq 0 ] && [ $size -ge 64 ] && modes="1 2 3 10"
+        for mode in $modes; do
+            set -- $(measure $mode $size $offset $CHUNK)
+            name=digest
+            [ $mode -eq 2 ] && name=update
+            [ $mode -eq 3 ] && name=hash64
+            [ $mode -eq 10 ] && name=sha512
+            align=aligned
+            [ $offset -ne 0 ] && align=+$offset
+            awk -v name=$name -v size=$size -v align=$align -v total=$1 -v base=$base -v calls=$2 'BEGIN {
+                cost = total - base
+                blocks = name == "hash64" ? 2 * int(size / 64) : int((size + 8) / 64) + 1
+                if (name == "sha512") blocks = int((size + 16) / 128) + 1
+                printf "%-8s %7d %6s %13d %11s %11d %11.1f\n", name, size, align, cost,
+                    size ? sprintf("%.2f", cost / size) : "-", calls, calls / blocks
+            }'
+        done
+    done
+done
+
+# size / BATCH_MESSAGE messages per run, word aligned
+for size in 1024 4096 16384; do
+    base=$(measure 0 $size 0 $BATCH_MESSAGE | cut -d' ' -f1)
+    for mode in 6 7; do
+        set -- $(measure $mode $size 0 $BATCH_MESSAGE)
+        name=batch
+        [ $mode -eq 7 ] && name=separate
+        awk -v name=$name -v size=$size -v total=$1 -v base=$base -v calls=$2 -v message=$BATCH_MESSAGE 'BEGIN {
+            cost = total - base
+            blocks = int(size / message) * (int((message + 8) / 64) + 1)
+            printf "%-8s %7d %6s %13d %11.2f %11d %11.1f\n", name, size, "x" message, cost, cost / size, calls, calls / blocks
+        }'
+    done
+    # size / 32 leaves, two blocks per inner node
+    set -- $(measure 8 $size 0 $BATCH_MESSAGE)
+    awk -v size=$size -v total=$1 -v base=$base -v calls=$2 'BEGIN {
+        cost = total - base
+        blocks = 2 * (size / 32 - 1)
+        printf "%-8s %7d %6s %13d %11.2f %11d %11.1f\n", "merkle", size, "x32", cost, cost / size, calls, calls / blocks
+    }'
+done
+rm -f run.out
@@ -12,6 +12,14 @@ uint64_t blspair_pop(void);
 void blssum_g1(uint64_t x);
 uint64_t blssum_pop(void);
 
+#ifdef ZKWASM_HOST_STATS
+#define blspair_g1(x) ZKWASM_HOST_CALL(ZKWASM_HOST_BLSPAIR_G1, blspair_g1(x))
+#define blspair_g2(x) ZKWASM_HOST_CALL(ZKWASM_HOST_BLSPAIR_G2, blspair_g2(x))
+#define blspair_pop() ZKWASM_HOST_CALL(ZKWASM_HOST_BLSPAIR_POP, blspair_pop())
+#define blssum_g1(x) ZKWASM_HOST_CALL(ZKWASM_HOST_BLSSUM_G1, blssum_g1(x))
+#define blssum_pop() ZKWASM_HOST_CALL(ZKWASM_HOST_BLSSUM_POP, blssum_pop())
+#endif
+
 void blspair(uint64_t* g1, uint64_t* g2, uint64_t* g3);
 void blssum(uint32_t size, uint64_t* g1, uint64_t *gr);
 
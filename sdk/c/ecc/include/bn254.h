@@ -12,6 +12,14 @@ uint64_t bn254pair_pop(void);
 void bn254msm_g1(uint64_t x);
 uint64_t bn254msm_pop(void);
 
+#ifdef ZKWASM_HOST_STATS
+#define bn254pair_g1(x) ZKWASM_HOST_CALL(ZKWASM_HOST_BN254PAIR_G1, bn254pair_g1(x))
+#define bn254pair_g2(x) ZKWASM_HOST_CALL(ZKWASM_HOST_BN254PAIR_G2, bn254pair_g2(x))
+#define bn254pair_pop() ZKWASM_HOST_CALL(ZKWASM_HOST_BN254PAIR_POP, bn254pair_pop())
+#define bn254msm_g1(x) ZKWASM_HOST_CALL(ZKWASM_HOST_BN254MSM_G1, bn254msm_g1(x))
+#define bn254msm_pop() ZKWASM_HOST_CALL(ZKWASM_HOST_BN254MSM_POP, bn254msm_pop())
+#endif
+
 void bn254pair(uint64_t* g1, uint64_t* g2, uint64_t* g3);
 void bn254msm(uint32_t size, uint64_t* g1, uint64_t *gr);
 
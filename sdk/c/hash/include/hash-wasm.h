@@ -1,6 +1,11 @@
+#ifndef __ZKWASM_HASH__
+
+#define __ZKWASM_HASH__
+
 #include <stdint.h>
 #include <stdalign.h>
 
+#if defined(__wasm__)
 static __inline__ void *memset(void *dst, const uint8_t value, uint32_t cnt)
 {
   uint8_t *p = dst;
@@ -10,19 +15,35 @@ static __inline__ void *memset(void *dst, const uint8_t value, uint32_t cnt)
   }
   return dst;
 }
+#else
+#include <string.h>
+#endif
+
+/* Word types for buffers of unknown alignment. wasm loads and stores of any
+ * alignment cost the same, and native builds get safe unaligned accesses. */
+typedef uint32_t unaligned_u32 __attribute__((aligned(1), may_alias));
+typedef uint64_t unaligned_u64 __attribute__((aligned(1), may_alias));
 
+/* Copies cnt bytes in 8-byte words, with at most one 4-byte word and three
+ * single bytes at the end; either pointer may be unaligned. */
 static __inline__ void *memcpy2(void *dst, const void *src, uint32_t cnt)
 {
-  uint64_t *destination64 = dst;
-  const uint64_t *source64 = src;
+  uint8_t *destination = dst;
+  const uint8_t *source = src;
   while (cnt >= 8)
   {
-    *(destination64++) = *(source64++);
+    *(unaligned_u64 *)destination = *(const unaligned_u64 *)source;
+    destination += 8;
+    source += 8;
     cnt -= 8;
   }
-
-  uint8_t *destination = (uint8_t *)destination64;
-  const uint8_t *source = (uint8_t *)source64;
+  if (cnt >= 4)
+  {
+    *(unaligned_u32 *)destination = *(const unaligned_u32 *)source;
+    destination += 4;
+    source += 4;
+    cnt -= 4;
+  }
   while (cnt)
   {
     *(destination++) = *(source++);
@@ -114,4 +135,97 @@ static __inline__ void memset128(void *dst, const uint8_t value)
   }
 }
 
+/*
+ * SHA-256 state owned by the caller, so that several hashes can be in
+ * progress at once. Hash_Init/Hash_Update/Hash_Final work on one shared
+ * context and are kept for existing code.
+ */
+struct sha256_ctx
+{
+  uint32_t message[16];   /* 512-bit buffer for leftovers */
+  uint64_t length;        /* number of processed bytes */
+  uint32_t hash[8];       /* 256-bit algorithm internal hashing state */
+  uint32_t digest_length; /* length of the algorithm digest in bytes */
+};
+
+void SHA256_Init(struct sha256_ctx *ctx);
+void SHA256_Update(struct sha256_ctx *ctx, uint32_t size, const uint8_t *data);
+void SHA256_Final(struct sha256_ctx *ctx, uint8_t *output);
+/* Hash size bytes of wasm_input(is_public) without staging them, see sha256.c */
+void SHA256_UpdateInput(struct sha256_ctx *ctx, uint32_t size, uint32_t is_public, uint8_t *copy);
+
+/*
+ * State after a prefix of whole 64-byte blocks. A constant prefix can be
+ * exported once, e.g. with tools/midstate at build time, and every message
+ * resumes from it instead of compressing the prefix again.
+ */
+struct sha256_midstate
+{
+  uint32_t hash[8];
+  uint64_t length;
+};
+
+void SHA256_Export(const struct sha256_ctx *ctx, struct sha256_midstate *state);
+void SHA256_Resume(struct sha256_ctx *ctx, const struct sha256_midstate *state);
+
+void Hash_Init(uint32_t bits);
+void Hash_Update(uint32_t size, const uint8_t *data);
+void Hash_Final(uint8_t *output);
 void SHA256_Digest(uint8_t *output, uint32_t size, const uint8_t *msg);
+void SHA256_DigestInput(uint8_t *output, uint32_t size, uint32_t is_public, uint8_t *copy);
+/* count messages of size bytes each, back to back, into count * 32 bytes of digests */
+void SHA256_DigestBatch(uint8_t *output, const uint8_t *msgs, uint32_t count, uint32_t size);
+/* SHA-256 of exactly 64 bytes (two Merkle children), word aligned buffers */
+void SHA256_Hash64(uint32_t *output, const uint32_t *left, const uint32_t *right);
+
+/* SHA-512 and SHA-384 state, in 64-bit words, see sha512.c */
+struct sha512_ctx
+{
+  uint64_t message[16];   /* 1024-bit buffer for leftovers */
+  uint64_t length;        /* number of processed bytes */
+  uint64_t hash[8];       /* 512-bit algorithm internal hashing state */
+  uint32_t digest_length; /* 64 for SHA-512, 48 for SHA-384 */
+};
+
+void SHA512_Init(struct sha512_ctx *ctx);
+void SHA384_Init(struct sha512_ctx *ctx);
+void SHA512_Update(struct sha512_ctx *ctx, uint32_t size, const uint8_t *data);
+void SHA512_Final(struct sha512_ctx *ctx, uint8_t *output);
+void SHA512_Digest(uint8_t *output, uint32_t size, const uint8_t *msg);
+void SHA384_Digest(uint8_t *output, uint32_t size, const uint8_t *msg);
+
+int keccak(int r, int c, int n, int l, uint8_t *M, uint8_t *O);
+/* Keccak-f[1600] on 25 lanes, in place */
+void keccakf1600(uint64_t *state);
+
+/*
+ * Incremental Keccak[1600] sponge: absorb a message in chunks of any size
+ * straight from the caller's buffers, then squeeze any amount of output.
+ */
+struct keccak_ctx
+{
+  uint64_t state[25];
+  uint32_t rate;      /* block size in bytes */
+  uint32_t pos;       /* bytes absorbed into, or squeezed from, the current block */
+  uint8_t delim;      /* domain separation and first padding bit */
+  uint8_t squeezing;
+};
+
+void Keccak_Init(struct keccak_ctx *ctx, uint32_t rate, uint8_t delim);
+void Keccak_Absorb(struct keccak_ctx *ctx, uint32_t size, const uint8_t *data);
+void Keccak_Finalize(struct keccak_ctx *ctx);
+void Keccak_Squeeze(struct keccak_ctx *ctx, uint32_t size, uint8_t *output);
+/* SHAKE128/256 sponges: absorb with Keccak_Absorb, stream with Keccak_Squeeze */
+void SHAKE128_Init(struct keccak_ctx *ctx);
+void SHAKE256_Init(struct keccak_ctx *ctx);
+/* Ethereum Keccak-256 (0x01 padding) and FIPS 202 SHA-3 (0x06 padding) */
+int keccak256(uint8_t *M, int l, uint8_t *O);
+int sha3_224(uint8_t *M, int l, uint8_t *O);
+int sha3_256(uint8_t *M, int l, uint8_t *O);
+int sha3_384(uint8_t *M, int l, uint8_t *O);
+int sha3_512(uint8_t *M, int l, uint8_t *O);
+/* n bytes of SHAKE128/256 output */
+int shake128(uint8_t *M, int l, uint8_t *O, int n);
+int shake256(uint8_t *M, int l, uint8_t *O, int n);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef __ZKWASM_HMAC__
+
+#define __ZKWASM_HMAC__
+
+#include <stdint.h>
+#include "hash-wasm.h"
+
+/*
+ * HMAC-SHA256 (RFC 2104) and HKDF-SHA256 (RFC 5869). A key is expanded once
+ * into the midstates after its ipad and opad blocks; every message then
+ * costs the compressions of the message plus one for the outer hash.
+ */
+struct hmac_sha256_key
+{
+  struct sha256_midstate inner;
+  struct sha256_midstate outer;
+};
+
+/* key_size bytes of key into the ipad/opad midstates */
+void HMAC_SHA256_SetKey(struct hmac_sha256_key *key, uint32_t key_size, const uint8_t *key_data);
+/* start a MAC: the message goes through SHA256_Update (or SHA256_UpdateInput) on ctx */
+void HMAC_SHA256_Init(struct sha256_ctx *ctx, const struct hmac_sha256_key *key);
+/* 32 byte MAC of the message hashed into ctx */
+void HMAC_SHA256_Final(struct sha256_ctx *ctx, const struct hmac_sha256_key *key, uint8_t *output);
+/* 32 byte MAC of size bytes of msg */
+void HMAC_SHA256(uint8_t *output, const struct hmac_sha256_key *key, uint32_t size, const uint8_t *msg);
+
+/* 32 byte pseudorandom key from a salt (may be empty) and input key material */
+void HKDF_SHA256_Extract(uint8_t *prk, uint32_t salt_size, const uint8_t *salt, uint32_t ikm_size, const uint8_t *ikm);
+/* length bytes of output key material, at most 255 * 32 */
+void HKDF_SHA256_Expand(uint8_t *okm, uint32_t length, const uint8_t *prk, uint32_t info_size, const uint8_t *info);
+
+#endif
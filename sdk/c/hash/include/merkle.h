@@ -0,0 +1,24 @@
+#ifndef __ZKWASM_MERKLE__
+
+#define __ZKWASM_MERKLE__
+
+#include <stdint.h>
+
+/*
+ * Binary SHA-256 Merkle trees over 32-byte nodes, hashed with
+ * SHA256_Hash64(left || right). A level with an odd number of nodes moves
+ * its last node up unchanged, so the shape of the tree, and the length of
+ * every proof, follows from the number of leaves.
+ *
+ * Nodes are eight words holding the 32 digest bytes in memory order.
+ */
+
+/* Root of count leaves, computed in place: nodes[0..7] holds it afterwards */
+void SHA256_MerkleRoot(uint32_t *nodes, uint32_t count);
+/* 1 when the proof read from wasm_input(is_public) links leaf index to root */
+uint32_t SHA256_MerkleVerifyInput(const uint32_t *root, const uint32_t *leaf, uint32_t index,
+                                  uint32_t count, uint32_t is_public);
+/* number of siblings in the proof of leaf index */
+uint32_t SHA256_MerkleProofLength(uint32_t index, uint32_t count);
+
+#endif
@@ -0,0 +1,126 @@
+#include "hmac.h"
+#include "zkwasmsdk.h"
+
+#define hmac_block_size 64
+#define hmac_hash_size 32
+
+/* midstate after one block of the key xor'ed with pad in every byte */
+static void hmac_pad_state(struct sha256_midstate *state, const uint32_t block[16], uint32_t pad)
+{
+  struct sha256_ctx ctx;
+  uint32_t padded[16];
+
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 16; i++)
+  {
+    padded[i] = block[i] ^ pad;
+  }
+  SHA256_Init(&ctx);
+  SHA256_Update(&ctx, hmac_block_size, (const uint8_t *)padded);
+  SHA256_Export(&ctx, state);
+}
+
+/**
+ * Precompute the inner and outer hash states of a key. Keys longer than a
+ * block are hashed first, shorter ones are padded with zeros.
+ *
+ * @param key states to fill
+ * @param key_size length of the key
+ * @param key_data the key
+ */
+void HMAC_SHA256_SetKey(struct hmac_sha256_key *key, uint32_t key_size, const uint8_t *key_data)
+{
+  uint32_t block[16];
+
+  for (int i = 0; i < 16; i++)
+  {
+    block[i] = 0;
+  }
+  if (key_size > hmac_block_size)
+  {
+    SHA256_Digest((uint8_t *)block, key_size, key_data);
+  }
+  else
+  {
+    memcpy2(block, key_data, key_size);
+  }
+  hmac_pad_state(&key->inner, block, 0x36363636);
+  hmac_pad_state(&key->outer, block, 0x5c5c5c5c);
+}
+
+/**
+ * Start the inner hash of a MAC from the key's ipad state.
+ *
+ * @param ctx context to initialize
+ * @param key states from HMAC_SHA256_SetKey
+ */
+void HMAC_SHA256_Init(struct sha256_ctx *ctx, const struct hmac_sha256_key *key)
+{
+  SHA256_Resume(ctx, &key->inner);
+}
+
+/**
+ * Finish the inner hash and hash its digest from the key's opad state.
+ *
+ * @param ctx context started by HMAC_SHA256_Init, holding the message
+ * @param key the key ctx was started with
+ * @param output 32 byte MAC
+ */
+void HMAC_SHA256_Final(struct sha256_ctx *ctx, const struct hmac_sha256_key *key, uint8_t *output)
+{
+  uint32_t inner[8];
+
+  SHA256_Final(ctx, (uint8_t *)inner);
+  SHA256_Resume(ctx, &key->outer);
+  SHA256_Update(ctx, hmac_hash_size, (const uint8_t *)inner);
+  SHA256_Final(ctx, output);
+}
+
+void HMAC_SHA256(uint8_t *output, const struct hmac_sha256_key *key, uint32_t size, const uint8_t *msg)
+{
+  struct sha256_ctx ctx;
+  HMAC_SHA256_Init(&ctx, key);
+  SHA256_Update(&ctx, size, msg);
+  HMAC_SHA256_Final(&ctx, key, output);
+}
+
+void HKDF_SHA256_Extract(uint8_t *prk, uint32_t salt_size, const uint8_t *salt, uint32_t ikm_size, const uint8_t *ikm)
+{
+  struct hmac_sha256_key key;
+  /* an empty salt is the same HMAC key as 32 zero bytes */
+  HMAC_SHA256_SetKey(&key, salt_size, salt);
+  HMAC_SHA256(prk, &key, ikm_size, ikm);
+}
+
+/**
+ * HKDF-Expand: T(n) = HMAC(prk, T(n - 1) || info || n), concatenated and cut
+ * to length. The key states of prk are computed once for all blocks.
+ *
+ * @param okm length bytes of output
+ * @param length at most 255 * 32
+ * @param prk 32 byte pseudorandom key
+ * @param info_size length of info
+ * @param info context and application specific information
+ */
+void HKDF_SHA256_Expand(uint8_t *okm, uint32_t length, const uint8_t *prk, uint32_t info_size, const uint8_t *info)
+{
+  struct hmac_sha256_key key;
+  struct sha256_ctx ctx;
+  uint32_t t[8];
+  uint8_t counter = 1;
+
+  require(length <= 255 * hmac_hash_size);
+  HMAC_SHA256_SetKey(&key, hmac_hash_size, prk);
+  for (uint32_t done = 0; done < length; done += hmac_hash_size, counter++)
+  {
+    HMAC_SHA256_Init(&ctx, &key);
+    if (done)
+    {
+      SHA256_Update(&ctx, hmac_hash_size, (const uint8_t *)t);
+    }
+    SHA256_Update(&ctx, info_size, info);
+    SHA256_Update(&ctx, 1, &counter);
+    HMAC_SHA256_Final(&ctx, &key, (uint8_t *)t);
+    memcpy2(okm + done, t, length - done < hmac_hash_size ? length - done : hmac_hash_size);
+  }
+}
@@ -3,7 +3,20 @@
 #include "stdint.h"
 
 /* 64 bitwise rotation to left */
-#define ROTL64(x, y) (((x) << (y)) | ((x) >> (64 - (y))))
+#define ROTL64(x, y) (((x) << (y)) | ((x) >> ((64 - (y)) & 63)))
+
+#if defined(__wasm__) && defined(ZKWASM_KECCAKF)
+/*
+ * Keccak-f[1600] in the host: push the 25 lanes in state order, then pop the
+ * 25 permuted lanes in the same order.
+ */
+void zkwasm_keccakf_push(uint64_t x);
+uint64_t zkwasm_keccakf_pop(void);
+#ifdef ZKWASM_HOST_STATS
+#define zkwasm_keccakf_push(x) ZKWASM_HOST_CALL(ZKWASM_HOST_KECCAKF_PUSH, zkwasm_keccakf_push(x))
+#define zkwasm_keccakf_pop() ZKWASM_HOST_CALL(ZKWASM_HOST_KECCAKF_POP, zkwasm_keccakf_pop())
+#endif
+#endif
 
 typedef struct {
 	int b, l, w, nr;
@@ -160,6 +173,132 @@ int keccakf(int rounds, uint64_t* state)
   return 0;
 }
 
+#if defined(__wasm__) && defined(ZKWASM_KECCAKF)
+/* Keccak-f[1600] as one host call per lane each way */
+void keccakf1600(uint64_t* state)
+{
+  int i;
+
+#pragma clang loop unroll(full)
+  for (i = 0; i < 25; ++i) {
+    zkwasm_keccakf_push(state[i]);
+  }
+#pragma clang loop unroll(full)
+  for (i = 0; i < 25; ++i) {
+    state[i] = zkwasm_keccakf_pop();
+  }
+}
+#else
+/*
+ * Keccak-f[1600] with the 24 rounds run on 25 locals: theta, rho and pi are
+ * fused into one pass that writes the rotated lanes to their pi positions in
+ * b, chi writes them back to a, and every rotation amount is a constant.
+ * Lane a[x + 5y] is state[x + 5y] as in the generic functions above.
+ */
+void keccakf1600(uint64_t* state)
+{
+  uint64_t a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12;
+  uint64_t a13, a14, a15, a16, a17, a18, a19, a20, a21, a22, a23, a24;
+  uint64_t b0, b1, b2, b3, b4, b5, b6, b7, b8, b9, b10, b11, b12;
+  uint64_t b13, b14, b15, b16, b17, b18, b19, b20, b21, b22, b23, b24;
+  uint64_t c0, c1, c2, c3, c4, d0, d1, d2, d3, d4;
+  int i;
+
+  a0 = state[0]; a1 = state[1]; a2 = state[2]; a3 = state[3]; a4 = state[4];
+  a5 = state[5]; a6 = state[6]; a7 = state[7]; a8 = state[8]; a9 = state[9];
+  a10 = state[10]; a11 = state[11]; a12 = state[12]; a13 = state[13]; a14 = state[14];
+  a15 = state[15]; a16 = state[16]; a17 = state[17]; a18 = state[18]; a19 = state[19];
+  a20 = state[20]; a21 = state[21]; a22 = state[22]; a23 = state[23]; a24 = state[24];
+
+  for (i = 0; i < 24; ++i) {
+    /* theta */
+    c0 = a0 ^ a5 ^ a10 ^ a15 ^ a20;
+    c1 = a1 ^ a6 ^ a11 ^ a16 ^ a21;
+    c2 = a2 ^ a7 ^ a12 ^ a17 ^ a22;
+    c3 = a3 ^ a8 ^ a13 ^ a18 ^ a23;
+    c4 = a4 ^ a9 ^ a14 ^ a19 ^ a24;
+    d0 = c4 ^ ROTL64(c1, 1);
+    d1 = c0 ^ ROTL64(c2, 1);
+    d2 = c1 ^ ROTL64(c3, 1);
+    d3 = c2 ^ ROTL64(c4, 1);
+    d4 = c3 ^ ROTL64(c0, 1);
+
+    /* rho and pi: b[y + 5 * ((2x + 3y) % 5)] = rotl(a[x + 5y] ^ d[x], r[x + 5y]) */
+    b0 = a0 ^ d0;
+    b1 = ROTL64(a6 ^ d1, 44);
+    b2 = ROTL64(a12 ^ d2, 43);
+    b3 = ROTL64(a18 ^ d3, 21);
+    b4 = ROTL64(a24 ^ d4, 14);
+    b5 = ROTL64(a3 ^ d3, 28);
+    b6 = ROTL64(a9 ^ d4, 20);
+    b7 = ROTL64(a10 ^ d0, 3);
+    b8 = ROTL64(a16 ^ d1, 45);
+    b9 = ROTL64(a22 ^ d2, 61);
+    b10 = ROTL64(a1 ^ d1, 1);
+    b11 = ROTL64(a7 ^ d2, 6);
+    b12 = ROTL64(a13 ^ d3, 25);
+    b13 = ROTL64(a19 ^ d4, 8);
+    b14 = ROTL64(a20 ^ d0, 18);
+    b15 = ROTL64(a4 ^ d4, 27);
+    b16 = ROTL64(a5 ^ d0, 36);
+    b17 = ROTL64(a11 ^ d1, 10);
+    b18 = ROTL64(a17 ^ d2, 15);
+    b19 = ROTL64(a23 ^ d3, 56);
+    b20 = ROTL64(a2 ^ d2, 62);
+    b21 = ROTL64(a8 ^ d3, 55);
+    b22 = ROTL64(a14 ^ d4, 39);
+    b23 = ROTL64(a15 ^ d0, 41);
+    b24 = ROTL64(a21 ^ d1, 2);
+
+    /* chi */
+    a0 = b0 ^ (~b1 & b2);
+    a1 = b1 ^ (~b2 & b3);
+    a2 = b2 ^ (~b3 & b4);
+    a3 = b3 ^ (~b4 & b0);
+    a4 = b4 ^ (~b0 & b1);
+    a5 = b5 ^ (~b6 & b7);
+    a6 = b6 ^ (~b7 & b8);
+    a7 = b7 ^ (~b8 & b9);
+    a8 = b8 ^ (~b9 & b5);
+    a9 = b9 ^ (~b5 & b6);
+    a10 = b10 ^ (~b11 & b12);
+    a11 = b11 ^ (~b12 & b13);
+    a12 = b12 ^ (~b13 & b14);
+    a13 = b13 ^ (~b14 & b10);
+    a14 = b14 ^ (~b10 & b11);
+    a15 = b15 ^ (~b16 & b17);
+    a16 = b16 ^ (~b17 & b18);
+    a17 = b17 ^ (~b18 & b19);
+    a18 = b18 ^ (~b19 & b15);
+    a19 = b19 ^ (~b15 & b16);
+    a20 = b20 ^ (~b21 & b22);
+    a21 = b21 ^ (~b22 & b23);
+    a22 = b22 ^ (~b23 & b24);
+    a23 = b23 ^ (~b24 & b20);
+    a24 = b24 ^ (~b20 & b21);
+
+    /* iota */
+    a0 ^= RC[i];
+  }
+
+  state[0] = a0; state[1] = a1; state[2] = a2; state[3] = a3; state[4] = a4;
+  state[5] = a5; state[6] = a6; state[7] = a7; state[8] = a8; state[9] = a9;
+  state[10] = a10; state[11] = a11; state[12] = a12; state[13] = a13; state[14] = a14;
+  state[15] = a15; state[16] = a16; state[17] = a17; state[18] = a18; state[19] = a19;
+  state[20] = a20; state[21] = a21; state[22] = a22; state[23] = a23; state[24] = a24;
+}
+#endif
+
+/* Keccak-f[b] for lanes of w bits, unrolled for b = 1600 */
+static void permute(int nr, int w, uint64_t* state)
+{
+  if (w == 64) {
+    keccakf1600(state);
+  } else {
+    keccakf(nr, state);
+  }
+}
+
 void sponge_absorb(int nr, int r, int w, int l, uint64_t* A, uint8_t* P)
 {
   /* absorbing phase */
@@ -176,61 +315,160 @@ void sponge_absorb(int nr, int r, int w, int l, uint64_t* A, uint8_t* P)
     }
 
     /* S = Keccak-f[r + c](S) */
-    keccakf(nr, A);
+    permute(nr, w, A);
   }
 }
 
-void sponge_squeeze(int nr, int r, int n, uint64_t* A, uint8_t* O)
+void sponge_squeeze(int nr, int r, int w, int n, uint64_t* A, uint8_t* O)
 {
-  /*
-    For SHA-3 we have r > n in any case, i.e., the squeezing phase
-      consists of one round.
-   */
-  int i = 0;
-  while (n) {
-    int size = r;
-
-    if (r > n) {
-        size = n;
-    }
+  /* n output bits as whole bytes, r / 8 of them per block, with a
+     permutation before every block after the first */
+  int block_size = r / 8;
+  int left = n / 8;
 
-    /* Copies A[0:size/8] to O[i:i + size/8 - 1] */
-    memcpy(&O[i], A, size/8);
-    i = i + size/8;
+  while (left) {
+    int size = left < block_size ? left : block_size;
 
-    n = n - size;
+    memcpy2(O, A, size);
+    O += size;
+    left -= size;
 
-    if (n > 0) {
-      keccakf(nr, A);
+    if (left) {
+      permute(nr, w, A);
     }
   }
 }
 
-int pad101(int r, int blocks, int l, uint8_t* M, uint8_t* P)
+/**
+ * Start a Keccak[1600] sponge.
+ *
+ * @param ctx context to initialize
+ * @param rate bit rate, a multiple of 64 below 1600
+ * @param delim domain bits and first padding bit: 0x01 for Keccak, 0x06 for
+ *   SHA-3, 0x1f for SHAKE
+ */
+void Keccak_Init(struct keccak_ctx *ctx, uint32_t rate, uint8_t delim)
 {
-  int block_size = r/8;
-
-  /* length of the padded block */
-  int block_len = (blocks + 1) * block_size;
+  require(rate > 0 && rate < 1600 && rate % 64 == 0);
+  memset(ctx->state, 0, sizeof(ctx->state));
+  ctx->rate = rate / 8;
+  ctx->pos = 0;
+  ctx->delim = delim;
+  ctx->squeezing = 0;
+}
 
-  /* zero out data and copy M into P */
-  memset(P, 0, block_len * sizeof(uint8_t));
+/**
+ * XOR message bytes into the state. Whole blocks are absorbed as lanes
+ * straight from data; only a partial block at either end goes byte by byte
+ * up to a lane boundary.
+ *
+ * @param ctx context that has not started squeezing
+ * @param size length of the chunk
+ * @param data message chunk, of any alignment
+ */
+void Keccak_Absorb(struct keccak_ctx *ctx, uint32_t size, const uint8_t *data)
+{
+  uint32_t rate = ctx->rate;
+  uint32_t pos = ctx->pos;
+  uint8_t *state8 = (uint8_t *)ctx->state;
+
+  require(!ctx->squeezing);
+  while (size) {
+    if (pos == 0 && size >= rate) {
+      for (uint32_t i = 0; i < rate / 8; i++) {
+        ctx->state[i] ^= ((const unaligned_u64 *)data)[i];
+      }
+      keccakf1600(ctx->state);
+      data += rate;
+      size -= rate;
+      continue;
+    }
 
-  int i;
-  for (i = 0; i < l; ++i) {
-      P[i] = M[i];
+    uint32_t n = rate - pos < size ? rate - pos : size;
+    uint32_t i = 0;
+    for (; i < n && ((pos + i) & 7); i++) {
+      state8[pos + i] ^= data[i];
+    }
+    for (; i + 8 <= n; i += 8) {
+      ctx->state[(pos + i) >> 3] ^= *(const unaligned_u64 *)(data + i);
+    }
+    for (; i < n; i++) {
+      state8[pos + i] ^= data[i];
+    }
+    pos += n;
+    data += n;
+    size -= n;
+    if (pos == rate) {
+      keccakf1600(ctx->state);
+      pos = 0;
+    }
   }
+  ctx->pos = pos;
+}
 
-  /* add padding bytes */
-  P[l] = 0x01;
-  P[block_len - 1] = 0x80;
+/**
+ * Pad the absorbed message in place and switch to squeezing.
+ *
+ * @param ctx context after the last Keccak_Absorb
+ */
+void Keccak_Finalize(struct keccak_ctx *ctx)
+{
+  uint8_t *state8 = (uint8_t *)ctx->state;
+
+  require(!ctx->squeezing);
+  state8[ctx->pos] ^= ctx->delim;
+  state8[ctx->rate - 1] ^= 0x80;
+  keccakf1600(ctx->state);
+  ctx->pos = 0;
+  ctx->squeezing = 1;
+}
 
-  /* padding */
-  if (l % block_size == 0) {
-    return l;
+/**
+ * Read output bytes, permuting whenever a block of output is used up.
+ * Finalizes the context first if needed.
+ *
+ * @param ctx context
+ * @param size number of bytes to read
+ * @param output receives size bytes
+ */
+void Keccak_Squeeze(struct keccak_ctx *ctx, uint32_t size, uint8_t *output)
+{
+  if (!ctx->squeezing) {
+    Keccak_Finalize(ctx);
+  }
+  while (size) {
+    if (ctx->pos == ctx->rate) {
+      keccakf1600(ctx->state);
+      ctx->pos = 0;
+    }
+    uint32_t n = ctx->rate - ctx->pos < size ? ctx->rate - ctx->pos : size;
+    memcpy2(output, (uint8_t *)ctx->state + ctx->pos, n);
+    ctx->pos += n;
+    output += n;
+    size -= n;
   }
+}
 
-  return block_len;
+/**
+ * Start SHAKE128 (FIPS 202): rate 1344, 0x1f domain padding. Absorb with
+ * Keccak_Absorb, then read any amount of output with Keccak_Squeeze, in
+ * chunks of any size as it is needed.
+ *
+ * @param ctx context to initialize
+ */
+void SHAKE128_Init(struct keccak_ctx *ctx)
+{
+  Keccak_Init(ctx, 1344, 0x1f);
+}
+
+/**
+ * Start SHAKE256 (FIPS 202): rate 1088, 0x1f domain padding.
+ *
+ * @param ctx context to initialize
+ */
+void SHAKE256_Init(struct keccak_ctx *ctx)
+{
+  Keccak_Init(ctx, 1088, 0x1f);
 }
 
 /* Keccak */
@@ -247,8 +485,8 @@ int keccak(int r, int c, int n, int l, uint8_t* M, uint8_t* O)
 {
   /* check parameters */
 
-  /* bit rate must be a multiple of the lane size */
-  if (r < 0 || (r % 8 != 0)) {
+  /* bit rate must be a multiple of the lane size, and leave some capacity */
+  if (r <= 0 || (r % 8 != 0) || c <= 0) {
     return -1;
   }
 
@@ -271,11 +509,6 @@ int keccak(int r, int c, int n, int l, uint8_t* M, uint8_t* O)
     return -3;
   }
 
-  /* state of 5x5 lanes, each of length 64 (for Keccak-f[1600]) */
-  uint64_t A[25];
-  /* zero out the state */
-  memset(A, 0, 25 * sizeof(uint64_t));
-
   /* lane width */
   int w = perms[j].w;
   /* number of rounds */
@@ -283,36 +516,133 @@ int keccak(int r, int c, int n, int l, uint8_t* M, uint8_t* O)
   /* block size in bytes */
   int block_size = r/8;
 
-  /* calculate how many blocks M consist of */
-  int blocks = l / block_size;
-  /* make room for padding, if necessary */
-  uint8_t P[block_size * (blocks + 1)];
+  if (w == 64 && r % 64 == 0) {
+    struct keccak_ctx ctx;
+    Keccak_Init(&ctx, r, 0x01);
+    Keccak_Absorb(&ctx, l, M);
+    Keccak_Squeeze(&ctx, n / 8, O);
+    return 0;
+  }
 
-  /* padding */
-  l = pad101(r, blocks, l, M, P);
+  /* narrower lanes: one padded block at a time */
+  uint64_t A[25];
+  uint64_t block[25];
+  memset(A, 0, 25 * sizeof(uint64_t));
 
-  sponge_absorb(nr, r, w, l, A, P);
-  sponge_squeeze(nr, r, n, A, O);
+  int offset;
+  for (offset = 0; offset + block_size <= l; offset += block_size) {
+    memset(block, 0, sizeof(block));
+    memcpy2(block, M + offset, block_size);
+    sponge_absorb(nr, r, w, block_size, A, (uint8_t*)block);
+  }
+
+  /* pad10*1 after the last partial (possibly empty) block */
+  memset(block, 0, sizeof(block));
+  memcpy2(block, M + offset, l - offset);
+  ((uint8_t*)block)[l - offset] ^= 0x01;
+  ((uint8_t*)block)[block_size - 1] ^= 0x80;
+  sponge_absorb(nr, r, w, block_size, A, (uint8_t*)block);
+
+  sponge_squeeze(nr, r, w, n, A, O);
 
   return 0;
 }
 
+/*
+ * Keccak[1600] hash of l bytes with a single output block, for constant
+ * rate (bytes), domain byte and digest length, so that the lane loops unroll
+ * and no parameters are checked at run time. The last partial block is
+ * XORed into the state directly and padded there.
+ */
+static __inline__ __attribute__((always_inline))
+void keccak1600_digest(const uint8_t* M, uint32_t l, uint8_t* O,
+                       const uint32_t rate, const uint8_t delim, const uint32_t outlen)
+{
+  uint64_t A[25];
+  uint8_t* A8 = (uint8_t*)A;
+  uint32_t i;
+
+#pragma clang loop unroll(full)
+  for (i = 0; i < 25; ++i) {
+    A[i] = 0;
+  }
+
+  while (l >= rate) {
+#pragma clang loop unroll(full)
+    for (i = 0; i < rate / 8; ++i) {
+      A[i] ^= ((const unaligned_u64*)M)[i];
+    }
+    keccakf1600(A);
+    M += rate;
+    l -= rate;
+  }
+
+  for (i = 0; i + 8 <= l; i += 8) {
+    A[i >> 3] ^= *(const unaligned_u64*)(M + i);
+  }
+  for (; i < l; ++i) {
+    A8[i] ^= M[i];
+  }
+  A8[l] ^= delim;
+  A8[rate - 1] ^= 0x80;
+  keccakf1600(A);
+
+#pragma clang loop unroll(full)
+  for (i = 0; i < outlen / 8; ++i) {
+    ((unaligned_u64*)O)[i] = A[i];
+  }
+  if (outlen & 7) {
+    memcpy2(O + (outlen & ~7u), A8 + (outlen & ~7u), outlen & 7);
+  }
+}
+
+/* Ethereum's Keccak-256: the original 0x01 padding */
+int keccak256(uint8_t* M, int l, uint8_t* O)
+{
+  keccak1600_digest(M, l, O, 136, 0x01, 32);
+  return 0;
+}
+
+/* FIPS 202 SHA-3, with the 0x06 domain padding */
 int sha3_512(uint8_t* M, int l, uint8_t* O)
 {
-  return keccak(576, 1024, 512, l, M, O);
+  keccak1600_digest(M, l, O, 72, 0x06, 64);
+  return 0;
 }
 
 int sha3_384(uint8_t* M, int l, uint8_t* O)
 {
-  return keccak(832, 768, 384, l, M, O);
+  keccak1600_digest(M, l, O, 104, 0x06, 48);
+  return 0;
 }
 
 int sha3_256(uint8_t* M, int l, uint8_t* O)
 {
-  return keccak(1088, 512, 256, l, M, O);
+  keccak1600_digest(M, l, O, 136, 0x06, 32);
+  return 0;
 }
 
 int sha3_224(uint8_t* M, int l, uint8_t* O)
 {
-  return keccak(1152, 448, 224, l, M, O);
+  keccak1600_digest(M, l, O, 144, 0x06, 28);
+  return 0;
+}
+
+/* n bytes of SHAKE output at once; use SHAKE*_Init to stream it instead */
+int shake128(uint8_t* M, int l, uint8_t* O, int n)
+{
+  struct keccak_ctx ctx;
+  SHAKE128_Init(&ctx);
+  Keccak_Absorb(&ctx, l, M);
+  Keccak_Squeeze(&ctx, n, O);
+  return 0;
+}
+
+int shake256(uint8_t* M, int l, uint8_t* O, int n)
+{
+  struct keccak_ctx ctx;
+  SHAKE256_Init(&ctx);
+  Keccak_Absorb(&ctx, l, M);
+  Keccak_Squeeze(&ctx, n, O);
+  return 0;
 }
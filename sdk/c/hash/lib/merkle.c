@@ -0,0 +1,113 @@
+#include "merkle.h"
+#include "hash-wasm.h"
+#include "zkwasmsdk.h"
+
+/**
+ * Hash a level of nodes into the next one until the root is left. Every
+ * parent overwrites a slot whose children have already been read, so no
+ * second buffer is needed.
+ *
+ * @param nodes count * 8 words of leaves, overwritten with the inner nodes
+ * @param count number of leaves, at least 1
+ */
+void SHA256_MerkleRoot(uint32_t *nodes, uint32_t count)
+{
+  require(count > 0);
+  while (count > 1)
+  {
+    uint32_t pairs = count >> 1;
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+      SHA256_Hash64(nodes + 8 * i, nodes + 16 * i, nodes + 16 * i + 8);
+    }
+    if (count & 1)
+    {
+      /* promote the unpaired node */
+#pragma clang loop unroll(full)
+      for (int j = 0; j < 8; j++)
+      {
+        nodes[8 * pairs + j] = nodes[16 * pairs + j];
+      }
+    }
+    count = pairs + (count & 1);
+  }
+}
+
+/**
+ * Number of siblings on the path from leaf index to the root: one per level,
+ * minus the levels where the node on the path is promoted.
+ *
+ * @param index position of the leaf
+ * @param count number of leaves
+ */
+uint32_t SHA256_MerkleProofLength(uint32_t index, uint32_t count)
+{
+  uint32_t length = 0;
+  for (; count > 1; index >>= 1, count = (count + 1) >> 1)
+  {
+    if (index != count - 1 || !(count & 1))
+    {
+      length++;
+    }
+  }
+  return length;
+}
+
+/**
+ * Walk from a leaf to the root with the siblings of an inclusion proof.
+ * Each sibling is read as four wasm_input(is_public) words, bytes in the
+ * layout of read_bytes_from_u64, from the leaf level upwards; levels where
+ * the node is promoted have no sibling. The proof has
+ * SHA256_MerkleProofLength(index, count) siblings, and all of them are read
+ * even when the result is 0.
+ *
+ * @param root expected root
+ * @param leaf the leaf node
+ * @param index position of the leaf, below count
+ * @param count number of leaves in the tree
+ * @param is_public 1 to read the proof from public inputs, 0 for private ones
+ * @return 1 when the path ends in root, 0 otherwise
+ */
+uint32_t SHA256_MerkleVerifyInput(const uint32_t *root, const uint32_t *leaf, uint32_t index,
+                                  uint32_t count, uint32_t is_public)
+{
+  uint32_t node[8];
+  uint64_t sibling64[4];
+  const uint32_t *sibling = (const uint32_t *)sibling64;
+  uint32_t diff = 0;
+
+  require(index < count);
+#pragma clang loop unroll(full)
+  for (int j = 0; j < 8; j++)
+  {
+    node[j] = leaf[j];
+  }
+
+  for (; count > 1; index >>= 1, count = (count + 1) >> 1)
+  {
+    if (index == count - 1 && (count & 1))
+    {
+      continue;
+    }
+#pragma clang loop unroll(full)
+    for (int j = 0; j < 4; j++)
+    {
+      sibling64[j] = wasm_input(is_public);
+    }
+    if (index & 1)
+    {
+      SHA256_Hash64(node, sibling, node);
+    }
+    else
+    {
+      SHA256_Hash64(node, node, sibling);
+    }
+  }
+
+#pragma clang loop unroll(full)
+  for (int j = 0; j < 8; j++)
+  {
+    diff |= node[j] ^ root[j];
+  }
+  return diff == 0;
+}
@@ -26,17 +26,17 @@
 #define ROTR32(dword, n) ((dword) >> (n) ^ ((dword) << (32 - (n))))
 #define bswap_32(x) __builtin_bswap32(x)
 
-struct sha256_ctx
-{
-  uint32_t message[16];   /* 512-bit buffer for leftovers */
-  uint64_t length;        /* number of processed bytes */
-  uint32_t hash[8];       /* 256-bit algorithm internal hashing state */
-  uint32_t digest_length; /* length of the algorithm digest in bytes */
-};
-
+/* context behind the Hash_Init/Hash_Update/Hash_Final wrappers */
 struct sha256_ctx sctx;
 struct sha256_ctx *ctx = &sctx;
 
+/* Initial values. These words were obtained by taking the first 32
+ * bits of the fractional parts of the square roots of the first
+ * eight prime numbers. */
+static const uint32_t SHA256_H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
 /* SHA-224 and SHA-256 constants for 64 rounds. These words represent
  * the first 32 bits of the fractional parts of the cube
  * roots of the first 64 prime numbers. */
@@ -53,13 +53,33 @@ static const uint32_t rhash_k256[64] = {
     0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
 
-#if defined(__wasm__)
+#if defined(__wasm__) && defined(ZKWASM_SHA256_COMPRESS)
+/*
+ * Whole-block compression in the host: push the state as 4 words of two
+ * hash entries (hash[2i] in the low half), then the block as 8 little endian
+ * u64 loads, then pop the new state in the same layout as it was pushed.
+ */
+void zkwasm_sha256_compress_push(uint64_t x);
+uint64_t zkwasm_sha256_compress_pop(void);
+#ifdef ZKWASM_HOST_STATS
+#define zkwasm_sha256_compress_push(x) ZKWASM_HOST_CALL(ZKWASM_HOST_SHA256_COMPRESS_PUSH, zkwasm_sha256_compress_push(x))
+#define zkwasm_sha256_compress_pop() ZKWASM_HOST_CALL(ZKWASM_HOST_SHA256_COMPRESS_POP, zkwasm_sha256_compress_pop())
+#endif
+#elif defined(__wasm__)
 uint32_t zkwasm_sha256_ch(uint32_t x, uint32_t y, uint32_t z);
 uint32_t zkwasm_sha256_maj(uint32_t x, uint32_t y, uint32_t z);
 uint32_t zkwasm_sha256_lsigma0(uint32_t x);
 uint32_t zkwasm_sha256_lsigma1(uint32_t x);
 uint32_t zkwasm_sha256_ssigma0(uint32_t x);
 uint32_t zkwasm_sha256_ssigma1(uint32_t x);
+#ifdef ZKWASM_HOST_STATS
+#define zkwasm_sha256_ch(x, y, z) ZKWASM_HOST_CALL(ZKWASM_HOST_SHA256_CH, zkwasm_sha256_ch(x, y, z))
+#define zkwasm_sha256_maj(x, y, z) ZKWASM_HOST_CALL(ZKWASM_HOST_SHA256_MAJ, zkwasm_sha256_maj(x, y, z))
+#define zkwasm_sha256_lsigma0(x) ZKWASM_HOST_CALL(ZKWASM_HOST_SHA256_LSIGMA0, zkwasm_sha256_lsigma0(x))
+#define zkwasm_sha256_lsigma1(x) ZKWASM_HOST_CALL(ZKWASM_HOST_SHA256_LSIGMA1, zkwasm_sha256_lsigma1(x))
+#define zkwasm_sha256_ssigma0(x) ZKWASM_HOST_CALL(ZKWASM_HOST_SHA256_SSIGMA0, zkwasm_sha256_ssigma0(x))
+#define zkwasm_sha256_ssigma1(x) ZKWASM_HOST_CALL(ZKWASM_HOST_SHA256_SSIGMA1, zkwasm_sha256_ssigma1(x))
+#endif
 #else
 /* The SHA256/224 functions defined by FIPS 180-3, 4.1.2 */
 /* Optimized version of zkwasm_sha256_ch(x,y,z)=((x & y) | (~x & z)) */
@@ -91,16 +111,10 @@ uint32_t zkwasm_sha256_ssigma1(uint32_t x);
 /**
  * Initialize context before calculaing hash.
  *
+ * @param ctx context to initialize
  */
-void sha256_init()
+void SHA256_Init(struct sha256_ctx *ctx)
 {
-  /* Initial values. These words were obtained by taking the first 32
-   * bits of the fractional parts of the square roots of the first
-   * eight prime numbers. */
-  static const uint32_t SHA256_H0[8] = {
-      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
-
   ctx->length = 0;
   ctx->digest_length = sha256_hash_size;
 
@@ -115,16 +129,40 @@ void sha256_init()
 
 void Hash_Init(uint32_t bits)
 {
-  sha256_init();
+  SHA256_Init(ctx);
 }
 
 /**
  * The core transformation. Process a 512-bit block.
  *
  * @param hash algorithm state
- * @param block the message block to process
+ * @param block the message block to process, of any alignment
  */
-static void sha256_process_block(uint32_t hash[8], uint32_t block[16])
+#if defined(__wasm__) && defined(ZKWASM_SHA256_COMPRESS)
+static void sha256_process_block(uint32_t hash[8], const unaligned_u32 *block)
+{
+  const unaligned_u64 *block64 = (const unaligned_u64 *)block;
+
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i += 2)
+  {
+    zkwasm_sha256_compress_push(hash[i] | (uint64_t)hash[i + 1] << 32);
+  }
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i++)
+  {
+    zkwasm_sha256_compress_push(block64[i]);
+  }
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i += 2)
+  {
+    uint64_t state = zkwasm_sha256_compress_pop();
+    hash[i] = (uint32_t)state;
+    hash[i + 1] = (uint32_t)(state >> 32);
+  }
+}
+#else
+static void sha256_process_block(uint32_t hash[8], const unaligned_u32 *block)
 {
   uint32_t A, B, C, D, E, F, G, H;
   uint32_t W[16];
@@ -176,14 +214,17 @@ static void sha256_process_block(uint32_t hash[8], uint32_t block[16])
   hash[0] += A, hash[1] += B, hash[2] += C, hash[3] += D;
   hash[4] += E, hash[5] += F, hash[6] += G, hash[7] += H;
 }
+#endif
 
 /**
  * Calculate message hash.
  * Can be called repeatedly with chunks of the message to be hashed.
  *
+ * @param ctx context initialized by SHA256_Init
  * @param size length of the message chunk
+ * @param data message chunk
  */
-void Hash_Update(uint32_t size, const uint8_t *data)
+void SHA256_Update(struct sha256_ctx *ctx, uint32_t size, const uint8_t *data)
 {
   const uint8_t *msg = data;
   uint32_t index = (uint32_t)ctx->length & 63;
@@ -193,26 +234,19 @@ void Hash_Update(uint32_t size, const uint8_t *data)
   if (index)
   {
     uint32_t left = sha256_block_size - index;
-    uint32_t end = size < left ? size : left;
-    uint8_t *message8 = (uint8_t *)ctx->message;
-    for (uint8_t i = 0; i < end; i++)
-    {
-      *(message8 + index + i) = msg[i];
-    }
+    memcpy2((uint8_t *)ctx->message + index, msg, size < left ? size : left);
     if (size < left)
       return;
 
     /* process partial block */
-    sha256_process_block(ctx->hash, (uint32_t *)ctx->message);
+    sha256_process_block(ctx->hash, ctx->message);
     msg += left;
     size -= left;
   }
 
   while (size >= sha256_block_size)
   {
-    uint32_t *aligned_message_block = (uint32_t *)msg;
-
-    sha256_process_block(ctx->hash, aligned_message_block);
+    sha256_process_block(ctx->hash, (const unaligned_u32 *)msg);
     msg += sha256_block_size;
     size -= sha256_block_size;
   }
@@ -220,18 +254,120 @@ void Hash_Update(uint32_t size, const uint8_t *data)
   if (size)
   {
     /* save leftovers */
-    for (uint8_t i = 0; i < size; i++)
+    memcpy2(ctx->message, msg, size);
+  }
+}
+
+/**
+ * Snapshot the state of a context that has hashed a whole number of blocks.
+ *
+ * @param ctx context after SHA256_Update calls totalling a multiple of 64 bytes
+ * @param state midstate to fill
+ */
+void SHA256_Export(const struct sha256_ctx *ctx, struct sha256_midstate *state)
+{
+  require((ctx->length & 63) == 0);
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i++)
+  {
+    state->hash[i] = ctx->hash[i];
+  }
+  state->length = ctx->length;
+}
+
+/**
+ * Initialize a context from a midstate, as if its prefix had been hashed.
+ *
+ * @param ctx context to initialize
+ * @param state midstate from SHA256_Export
+ */
+void SHA256_Resume(struct sha256_ctx *ctx, const struct sha256_midstate *state)
+{
+  require((state->length & 63) == 0);
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i++)
+  {
+    ctx->hash[i] = state->hash[i];
+  }
+  ctx->length = state->length;
+  ctx->digest_length = sha256_hash_size;
+}
+
+/**
+ * Hash size bytes read with wasm_input(is_public), in the layout of
+ * read_bytes_from_u64: eight bytes per input, little endian, the unused
+ * bytes of the last input dropped. Whole inputs go straight into the message
+ * block, so the data needs no buffer unless copy is given.
+ *
+ * @param ctx context initialized by SHA256_Init
+ * @param size number of bytes to read
+ * @param is_public 1 for public inputs, 0 for private ones
+ * @param copy if not NULL, receives the size bytes read
+ */
+void SHA256_UpdateInput(struct sha256_ctx *ctx, uint32_t size, uint32_t is_public, uint8_t *copy)
+{
+  uint64_t *message64 = (uint64_t *)ctx->message;
+  uint64_t word;
+
+  if (ctx->length & 7)
+  {
+    /* not on an input boundary of the block, go through the byte path */
+    while (size)
     {
-      *(((uint8_t *)ctx->message) + i) = msg[i];
+      uint32_t n = size < 8 ? size : 8;
+      word = wasm_input(is_public);
+      SHA256_Update(ctx, n, (const uint8_t *)&word);
+      for (uint32_t i = 0; copy && i < n; i++)
+      {
+        *copy++ = ((uint8_t *)&word)[i];
+      }
+      size -= n;
+    }
+    return;
+  }
+
+  uint32_t index = ((uint32_t)ctx->length & 63) >> 3;
+  ctx->length += size;
+  while (size >= 8)
+  {
+    word = wasm_input(is_public);
+    message64[index++] = word;
+    if (copy)
+    {
+      *(unaligned_u64 *)copy = word;
+      copy += 8;
+    }
+    if (index == 8)
+    {
+      sha256_process_block(ctx->hash, ctx->message);
+      index = 0;
+    }
+    size -= 8;
+  }
+  if (size)
+  {
+    /* bytes past the end are overwritten by later updates or cleared by SHA256_Final */
+    word = wasm_input(is_public);
+    message64[index] = word;
+    for (uint32_t i = 0; copy && i < size; i++)
+    {
+      copy[i] = ((uint8_t *)&word)[i];
     }
   }
 }
 
+void Hash_Update(uint32_t size, const uint8_t *data)
+{
+  SHA256_Update(ctx, size, data);
+}
+
 /**
  * Store calculated hash into the given array.
  *
+ * @param ctx context holding the whole message
+ * @param output 32 byte digest
  */
-void Hash_Final(uint8_t *output)
+void SHA256_Final(struct sha256_ctx *ctx, uint8_t *output)
 {
   uint32_t index = ((uint32_t)ctx->length & 63) >> 2;
   uint32_t shift = ((uint32_t)ctx->length & 3) * 8;
@@ -263,21 +399,219 @@ void Hash_Final(uint8_t *output)
   ctx->message[15] = bswap_32((uint32_t)(ctx->length << 3));
   sha256_process_block(ctx->hash, ctx->message);
 
+  /* digest_length is a whole number of words */
+  for (uint32_t i = 0; i < ctx->digest_length >> 2; i++)
+  {
+    ((unaligned_u32 *)output)[i] = bswap_32(ctx->hash[i]);
+  }
+}
+
+void Hash_Final(uint8_t *output)
+{
+  SHA256_Final(ctx, output);
+}
+
+#if defined(__wasm__) && defined(ZKWASM_SHA256_COMPRESS)
+/* The padding block of a 64-byte message, as sha256_process_block reads it */
+static const uint32_t sha256_pad64_block[16] = {
+    0x00000080, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x00020000};
+#else
+/* K[n] + W[n] for the padding block of a 64-byte message: 0x80, zeros and
+ * the bit length 512. Its message schedule is constant. */
+static const uint32_t sha256_pad64_kw[64] = {
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374, 0x649b69c1, 0xf0fe4786,
+    0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0,
+    0xfdb1232b, 0xc7353eb0, 0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd,
+    0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16, 0x007f3e86, 0x37088980,
+    0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431,
+    0x6ed41a95, 0x6d437890, 0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c,
+    0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76};
+
+#define ROUND_KW(a, b, c, d, e, f, g, h, n) ROUND(a, b, c, d, e, f, g, h, kw[n], 0)
+
+/* Compression with a precomputed K + W schedule */
+static void sha256_process_schedule(uint32_t hash[8], const uint32_t *kw)
+{
+  uint32_t A, B, C, D, E, F, G, H;
+
+  A = hash[0], B = hash[1], C = hash[2], D = hash[3];
+  E = hash[4], F = hash[5], G = hash[6], H = hash[7];
+
 #pragma clang loop unroll(full)
-  for (int32_t i = 7; i >= 0; i--)
+  for (int i = 0; i < 64; i += 8, kw += 8)
   {
-    ctx->hash[i] = bswap_32(ctx->hash[i]);
+    ROUND_KW(A, B, C, D, E, F, G, H, 0);
+    ROUND_KW(H, A, B, C, D, E, F, G, 1);
+    ROUND_KW(G, H, A, B, C, D, E, F, 2);
+    ROUND_KW(F, G, H, A, B, C, D, E, 3);
+    ROUND_KW(E, F, G, H, A, B, C, D, 4);
+    ROUND_KW(D, E, F, G, H, A, B, C, 5);
+    ROUND_KW(C, D, E, F, G, H, A, B, 6);
+    ROUND_KW(B, C, D, E, F, G, H, A, 7);
   }
 
-  for (uint8_t i = 0; i < ctx->digest_length; i++)
+  hash[0] += A, hash[1] += B, hash[2] += C, hash[3] += D;
+  hash[4] += E, hash[5] += F, hash[6] += G, hash[7] += H;
+}
+#endif
+
+/**
+ * SHA-256 of the 64-byte message left || right, the node hash of a binary
+ * Merkle tree. Digests are read and written as words, so all three pointers
+ * must be 4-byte aligned; output may alias left or right.
+ *
+ * @param output 32 byte digest
+ * @param left first 32 bytes of the message
+ * @param right last 32 bytes of the message
+ */
+void SHA256_Hash64(uint32_t *output, const uint32_t *left, const uint32_t *right)
+{
+  uint32_t hash[8], block[16];
+
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i++)
+  {
+    hash[i] = SHA256_H0[i];
+    block[i] = left[i];
+    block[i + 8] = right[i];
+  }
+  sha256_process_block(hash, block);
+#if defined(__wasm__) && defined(ZKWASM_SHA256_COMPRESS)
+  sha256_process_block(hash, sha256_pad64_block);
+#else
+  sha256_process_schedule(hash, sha256_pad64_kw);
+#endif
+
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i++)
   {
-    output[i] = *(((uint8_t *)ctx->hash) + i);
+    output[i] = bswap_32(hash[i]);
   }
 }
 
 void SHA256_Digest(uint8_t *output, uint32_t size, const uint8_t *msg)
 {
-  Hash_Init(256);
-  Hash_Update(size, msg);
-  Hash_Final(output);
+  struct sha256_ctx digest_ctx;
+  SHA256_Init(&digest_ctx);
+  SHA256_Update(&digest_ctx, size, msg);
+  SHA256_Final(&digest_ctx, output);
+}
+
+void SHA256_DigestInput(uint8_t *output, uint32_t size, uint32_t is_public, uint8_t *copy)
+{
+  struct sha256_ctx digest_ctx;
+  SHA256_Init(&digest_ctx);
+  SHA256_UpdateInput(&digest_ctx, size, is_public, copy);
+  SHA256_Final(&digest_ctx, output);
+}
+
+#if !defined(__wasm__) && defined(ZKWASM_SHA256_MB)
+/* multi-buffer backend of the native build, sdk/native/sha256_mb.c;
+ * returns how many of the leading messages it hashed */
+uint32_t sha256_mb_digest(uint8_t *output, const uint8_t *msgs, uint32_t count, uint32_t size);
+#endif
+
+#if !(defined(__wasm__) && defined(ZKWASM_SHA256_COMPRESS))
+/* K[n] + W[n] of a block, for a block that is the same for many messages */
+static void sha256_expand_schedule(uint32_t kw[64], const uint32_t block[16])
+{
+  uint32_t W[16];
+
+  for (int i = 0; i < 16; i++)
+  {
+    W[i] = bswap_32(block[i]);
+    kw[i] = rhash_k256[i] + W[i];
+  }
+  for (int i = 16; i < 64; i++)
+  {
+    kw[i] = rhash_k256[i] + RECALCULATE_W(W, (i & 15));
+  }
+}
+#endif
+
+/**
+ * SHA-256 of count messages of size bytes each, stored back to back. The
+ * padding of the last block is built once for the whole batch, and when the
+ * length field spills into a block of its own, that block's message schedule
+ * is computed once as well.
+ *
+ * @param output count * 32 bytes of digests, in message order
+ * @param msgs count * size bytes of messages
+ * @param count number of messages
+ * @param size length of every message
+ */
+void SHA256_DigestBatch(uint8_t *output, const uint8_t *msgs, uint32_t count, uint32_t size)
+{
+  uint32_t blocks = size >> 6, tail = size & 63;
+  uint32_t pad[16], last[16], length_words[16];
+  uint64_t bits = (uint64_t)size << 3;
+#if !(defined(__wasm__) && defined(ZKWASM_SHA256_COMPRESS))
+  uint32_t length_kw[64];
+#endif
+
+#if !defined(__wasm__) && defined(ZKWASM_SHA256_MB)
+  uint32_t done = sha256_mb_digest(output, msgs, count, size);
+  output += done * sha256_hash_size;
+  msgs += done * size;
+  count -= done;
+#endif
+
+  /* the padding: 0x80 after the tail, zeros, then the bit length */
+  for (int i = 0; i < 16; i++)
+  {
+    pad[i] = 0;
+    length_words[i] = 0;
+  }
+  ((uint8_t *)pad)[tail] = 0x80;
+  /* without room for the length it goes into a block shared by every message */
+  uint32_t *length_at = tail < 56 ? pad : length_words;
+  length_at[14] = bswap_32((uint32_t)(bits >> 32));
+  length_at[15] = bswap_32((uint32_t)bits);
+#if !(defined(__wasm__) && defined(ZKWASM_SHA256_COMPRESS))
+  if (tail >= 56)
+  {
+    sha256_expand_schedule(length_kw, length_words);
+  }
+#endif
+
+  for (uint32_t n = 0; n < count; n++, msgs += size, output += sha256_hash_size)
+  {
+    uint32_t hash[8];
+
+#pragma clang loop unroll(full)
+    for (int i = 0; i < 8; i++)
+    {
+      hash[i] = SHA256_H0[i];
+    }
+    for (uint32_t b = 0; b < blocks; b++)
+    {
+      sha256_process_block(hash, (const unaligned_u32 *)(msgs + b * sha256_block_size));
+    }
+
+    /* last message bytes over the shared padding */
+    for (int i = 0; i < 16; i++)
+    {
+      last[i] = pad[i];
+    }
+    memcpy2(last, msgs + blocks * sha256_block_size, tail);
+    sha256_process_block(hash, last);
+    if (tail >= 56)
+    {
+#if defined(__wasm__) && defined(ZKWASM_SHA256_COMPRESS)
+      sha256_process_block(hash, length_words);
+#else
+      sha256_process_schedule(hash, length_kw);
+#endif
+    }
+
+#pragma clang loop unroll(full)
+    for (int i = 0; i < 8; i++)
+    {
+      ((unaligned_u32 *)output)[i] = bswap_32(hash[i]);
+    }
+  }
 }
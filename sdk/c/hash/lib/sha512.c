@@ -0,0 +1,295 @@
+/* sha512.c - SHA-512/384 as defined by FIPS 180-4.
+ *
+ * The state, message schedule and length are kept in 64-bit words, which
+ * wasm adds and rotates in single instructions, so a 128-byte block costs
+ * about as many instructions as a 64-byte SHA-256 block.
+ */
+
+#include "hash-wasm.h"
+#include "zkwasmsdk.h"
+
+#define sha512_block_size 128
+#define sha512_hash_size 64
+#define sha384_hash_size 48
+#define ROTR64(qword, n) ((qword) >> (n) ^ ((qword) << (64 - (n))))
+#define bswap_64(x) __builtin_bswap64(x)
+
+/* Initial values: the first 64 bits of the fractional parts of the square
+ * roots of the first eight primes (SHA-512) and of the ninth to sixteenth
+ * primes (SHA-384). */
+static const uint64_t SHA512_H0[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL};
+static const uint64_t SHA384_H0[8] = {
+    0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL, 0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+    0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL, 0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL};
+
+/* The first 64 bits of the fractional parts of the cube roots of the first
+ * 80 primes. */
+static const uint64_t k512[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL};
+
+#if defined(__wasm__) && defined(ZKWASM_SHA512_COMPRESS)
+/*
+ * Whole-block compression in the host: push the 8 state words, then the
+ * block as 16 little endian u64 loads, then pop the 8 new state words.
+ */
+void zkwasm_sha512_compress_push(uint64_t x);
+uint64_t zkwasm_sha512_compress_pop(void);
+#ifdef ZKWASM_HOST_STATS
+#define zkwasm_sha512_compress_push(x) ZKWASM_HOST_CALL(ZKWASM_HOST_SHA512_COMPRESS_PUSH, zkwasm_sha512_compress_push(x))
+#define zkwasm_sha512_compress_pop() ZKWASM_HOST_CALL(ZKWASM_HOST_SHA512_COMPRESS_POP, zkwasm_sha512_compress_pop())
+#endif
+#endif
+
+/* The SHA-512 functions defined by FIPS 180-4, 4.1.3 */
+#define sha512_ch(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define sha512_maj(x, y, z) (((x) & (y)) ^ ((z) & ((x) ^ (y))))
+#define sha512_lsigma0(x) (ROTR64((x), 28) ^ ROTR64((x), 34) ^ ROTR64((x), 39))
+#define sha512_lsigma1(x) (ROTR64((x), 14) ^ ROTR64((x), 18) ^ ROTR64((x), 41))
+#define sha512_ssigma0(x) (ROTR64((x), 1) ^ ROTR64((x), 8) ^ ((x) >> 7))
+#define sha512_ssigma1(x) (ROTR64((x), 19) ^ ROTR64((x), 61) ^ ((x) >> 6))
+
+/* W[n] += sigma1(W[n - 2]) + W[n - 7] + sigma0(W[n - 15]) over a circular buffer */
+#define RECALCULATE_W(W, n) \
+  (W[n] += (sha512_ssigma1(W[(n - 2) & 15]) + W[(n - 7) & 15] + sha512_ssigma0(W[(n - 15) & 15])))
+
+#define ROUND(a, b, c, d, e, f, g, h, k, data)                           \
+  {                                                                      \
+    uint64_t T1 = h + sha512_lsigma1(e) + sha512_ch(e, f, g) + k + (data); \
+    d += T1, h = T1 + sha512_lsigma0(a) + sha512_maj(a, b, c);           \
+  }
+#define ROUND_1_16(a, b, c, d, e, f, g, h, n) \
+  ROUND(a, b, c, d, e, f, g, h, k512[n], W[n] = bswap_64(block[n]))
+#define ROUND_17_80(a, b, c, d, e, f, g, h, n) \
+  ROUND(a, b, c, d, e, f, g, h, k[n], RECALCULATE_W(W, n))
+
+static void sha512_init(struct sha512_ctx *ctx, const uint64_t *h0, uint32_t digest_length)
+{
+  ctx->length = 0;
+  ctx->digest_length = digest_length;
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i++)
+  {
+    ctx->hash[i] = h0[i];
+  }
+}
+
+/**
+ * Initialize context before calculating a SHA-512 hash.
+ *
+ * @param ctx context to initialize
+ */
+void SHA512_Init(struct sha512_ctx *ctx)
+{
+  sha512_init(ctx, SHA512_H0, sha512_hash_size);
+}
+
+/**
+ * Initialize context before calculating a SHA-384 hash. SHA512_Update and
+ * SHA512_Final are shared; the context remembers the digest length.
+ *
+ * @param ctx context to initialize
+ */
+void SHA384_Init(struct sha512_ctx *ctx)
+{
+  sha512_init(ctx, SHA384_H0, sha384_hash_size);
+}
+
+/**
+ * The core transformation. Process a 1024-bit block.
+ *
+ * @param hash algorithm state
+ * @param block the message block to process, of any alignment
+ */
+#if defined(__wasm__) && defined(ZKWASM_SHA512_COMPRESS)
+static void sha512_process_block(uint64_t hash[8], const unaligned_u64 *block)
+{
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i++)
+  {
+    zkwasm_sha512_compress_push(hash[i]);
+  }
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 16; i++)
+  {
+    zkwasm_sha512_compress_push(block[i]);
+  }
+#pragma clang loop unroll(full)
+  for (int i = 0; i < 8; i++)
+  {
+    hash[i] = zkwasm_sha512_compress_pop();
+  }
+}
+#else
+static void sha512_process_block(uint64_t hash[8], const unaligned_u64 *block)
+{
+  uint64_t A, B, C, D, E, F, G, H;
+  uint64_t W[16];
+  const uint64_t *k;
+  int i;
+
+  A = hash[0], B = hash[1], C = hash[2], D = hash[3];
+  E = hash[4], F = hash[5], G = hash[6], H = hash[7];
+
+  ROUND_1_16(A, B, C, D, E, F, G, H, 0);
+  ROUND_1_16(H, A, B, C, D, E, F, G, 1);
+  ROUND_1_16(G, H, A, B, C, D, E, F, 2);
+  ROUND_1_16(F, G, H, A, B, C, D, E, 3);
+  ROUND_1_16(E, F, G, H, A, B, C, D, 4);
+  ROUND_1_16(D, E, F, G, H, A, B, C, 5);
+  ROUND_1_16(C, D, E, F, G, H, A, B, 6);
+  ROUND_1_16(B, C, D, E, F, G, H, A, 7);
+  ROUND_1_16(A, B, C, D, E, F, G, H, 8);
+  ROUND_1_16(H, A, B, C, D, E, F, G, 9);
+  ROUND_1_16(G, H, A, B, C, D, E, F, 10);
+  ROUND_1_16(F, G, H, A, B, C, D, E, 11);
+  ROUND_1_16(E, F, G, H, A, B, C, D, 12);
+  ROUND_1_16(D, E, F, G, H, A, B, C, 13);
+  ROUND_1_16(C, D, E, F, G, H, A, B, 14);
+  ROUND_1_16(B, C, D, E, F, G, H, A, 15);
+
+#pragma clang loop unroll(full)
+  for (i = 16, k = &k512[16]; i < 80; i += 16, k += 16)
+  {
+    ROUND_17_80(A, B, C, D, E, F, G, H, 0);
+    ROUND_17_80(H, A, B, C, D, E, F, G, 1);
+    ROUND_17_80(G, H, A, B, C, D, E, F, 2);
+    ROUND_17_80(F, G, H, A, B, C, D, E, 3);
+    ROUND_17_80(E, F, G, H, A, B, C, D, 4);
+    ROUND_17_80(D, E, F, G, H, A, B, C, 5);
+    ROUND_17_80(C, D, E, F, G, H, A, B, 6);
+    ROUND_17_80(B, C, D, E, F, G, H, A, 7);
+    ROUND_17_80(A, B, C, D, E, F, G, H, 8);
+    ROUND_17_80(H, A, B, C, D, E, F, G, 9);
+    ROUND_17_80(G, H, A, B, C, D, E, F, 10);
+    ROUND_17_80(F, G, H, A, B, C, D, E, 11);
+    ROUND_17_80(E, F, G, H, A, B, C, D, 12);
+    ROUND_17_80(D, E, F, G, H, A, B, C, 13);
+    ROUND_17_80(C, D, E, F, G, H, A, B, 14);
+    ROUND_17_80(B, C, D, E, F, G, H, A, 15);
+  }
+
+  hash[0] += A, hash[1] += B, hash[2] += C, hash[3] += D;
+  hash[4] += E, hash[5] += F, hash[6] += G, hash[7] += H;
+}
+#endif
+
+/**
+ * Calculate message hash.
+ * Can be called repeatedly with chunks of the message to be hashed.
+ *
+ * @param ctx context initialized by SHA512_Init or SHA384_Init
+ * @param size length of the message chunk
+ * @param data message chunk
+ */
+void SHA512_Update(struct sha512_ctx *ctx, uint32_t size, const uint8_t *data)
+{
+  const uint8_t *msg = data;
+  uint32_t index = (uint32_t)ctx->length & 127;
+  ctx->length += size;
+
+  /* fill partial block */
+  if (index)
+  {
+    uint32_t left = sha512_block_size - index;
+    memcpy2((uint8_t *)ctx->message + index, msg, size < left ? size : left);
+    if (size < left)
+      return;
+
+    /* process partial block */
+    sha512_process_block(ctx->hash, ctx->message);
+    msg += left;
+    size -= left;
+  }
+
+  while (size >= sha512_block_size)
+  {
+    sha512_process_block(ctx->hash, (const unaligned_u64 *)msg);
+    msg += sha512_block_size;
+    size -= sha512_block_size;
+  }
+
+  if (size)
+  {
+    /* save leftovers */
+    memcpy2(ctx->message, msg, size);
+  }
+}
+
+/**
+ * Store calculated hash into the given array.
+ *
+ * @param ctx context holding the whole message
+ * @param output 64 byte (SHA-512) or 48 byte (SHA-384) digest
+ */
+void SHA512_Final(struct sha512_ctx *ctx, uint8_t *output)
+{
+  uint32_t index = ((uint32_t)ctx->length & 127) >> 3;
+  uint32_t shift = ((uint32_t)ctx->length & 7) * 8;
+
+  /* append the byte 0x80 to the message */
+  ctx->message[index] &= ~(0xFFFFFFFFFFFFFFFFULL << shift);
+  ctx->message[index++] ^= 0x80ULL << shift;
+
+  /* if no room left in the message to store the 128-bit message length */
+  if (index > 14)
+  {
+    while (index < 16)
+    {
+      ctx->message[index++] = 0;
+    }
+    sha512_process_block(ctx->hash, ctx->message);
+    index = 0;
+  }
+
+  while (index < 15)
+  {
+    ctx->message[index++] = 0;
+  }
+
+  /* bit length, whose top 64 bits are the top 3 bits of the byte length */
+  ctx->message[14] = bswap_64(ctx->length >> 61);
+  ctx->message[15] = bswap_64(ctx->length << 3);
+  sha512_process_block(ctx->hash, ctx->message);
+
+  for (uint32_t i = 0; i < ctx->digest_length >> 3; i++)
+  {
+    ((unaligned_u64 *)output)[i] = bswap_64(ctx->hash[i]);
+  }
+}
+
+void SHA512_Digest(uint8_t *output, uint32_t size, const uint8_t *msg)
+{
+  struct sha512_ctx digest_ctx;
+  SHA512_Init(&digest_ctx);
+  SHA512_Update(&digest_ctx, size, msg);
+  SHA512_Final(&digest_ctx, output);
+}
+
+void SHA384_Digest(uint8_t *output, uint32_t size, const uint8_t *msg)
+{
+  struct sha512_ctx digest_ctx;
+  SHA384_Init(&digest_ctx);
+  SHA512_Update(&digest_ctx, size, msg);
+  SHA512_Final(&digest_ctx, output);
+}
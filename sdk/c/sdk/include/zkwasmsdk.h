@@ -13,8 +13,56 @@
 #define NULL 0
 #endif
 
-#if defined(__wasm__)
+#ifdef ZKWASM_HOST_STATS
+/*
+ * Instrumentation build: every host import used by the sdk is counted in
+ * zkwasm_host_calls, indexed by the enum below. Build the sdk and the project
+ * with -DZKWASM_HOST_STATS and read the counters through the exported
+ * zkwasm_host_stats(id), e.g. at the end of zkmain.
+ */
+enum zkwasm_host_import {
+  ZKWASM_HOST_WASM_INPUT,
+  ZKWASM_HOST_REQUIRE,
+  ZKWASM_HOST_SHA256_CH,
+  ZKWASM_HOST_SHA256_MAJ,
+  ZKWASM_HOST_SHA256_LSIGMA0,
+  ZKWASM_HOST_SHA256_LSIGMA1,
+  ZKWASM_HOST_SHA256_SSIGMA0,
+  ZKWASM_HOST_SHA256_SSIGMA1,
+  ZKWASM_HOST_BN254PAIR_G1,
+  ZKWASM_HOST_BN254PAIR_G2,
+  ZKWASM_HOST_BN254PAIR_POP,
+  ZKWASM_HOST_BN254MSM_G1,
+  ZKWASM_HOST_BN254MSM_POP,
+  ZKWASM_HOST_BLSPAIR_G1,
+  ZKWASM_HOST_BLSPAIR_G2,
+  ZKWASM_HOST_BLSPAIR_POP,
+  ZKWASM_HOST_BLSSUM_G1,
+  ZKWASM_HOST_BLSSUM_POP,
+  ZKWASM_HOST_SHA256_COMPRESS_PUSH,
+  ZKWASM_HOST_SHA256_COMPRESS_POP,
+  ZKWASM_HOST_SHA512_COMPRESS_PUSH,
+  ZKWASM_HOST_SHA512_COMPRESS_POP,
+  ZKWASM_HOST_KECCAKF_PUSH,
+  ZKWASM_HOST_KECCAKF_POP,
+  ZKWASM_HOST_IMPORTS
+};
+
+extern uint64_t zkwasm_host_calls[ZKWASM_HOST_IMPORTS];
+WASM_EXPORT uint64_t zkwasm_host_stats(uint32_t id);
+
+/* A macro named after the import it wraps is not expanded again, so the
+ * inner call still reaches the import itself. */
+#define ZKWASM_HOST_CALL(id, call) (zkwasm_host_calls[id]++, call)
+#else
+#define ZKWASM_HOST_CALL(id, call) (call)
+#endif
+
+/* Host imports under wasm; a native build links the stand-ins in sdk/native */
 uint64_t wasm_input(uint32_t);
+#ifdef ZKWASM_HOST_STATS
+#define wasm_input(x) ZKWASM_HOST_CALL(ZKWASM_HOST_WASM_INPUT, wasm_input(x))
+#endif
 
 static inline uint64_t wasm_public_input()
 {
@@ -29,9 +77,16 @@ static inline uint64_t wasm_private_input()
 void assert(int cond);
 extern void require(int cond);
 
+#ifdef ZKWASM_HOST_STATS
+#define require(x) ZKWASM_HOST_CALL(ZKWASM_HOST_REQUIRE, require(x))
+#endif
+
+#if defined(__wasm__)
 // Sometimes LLVM emits these functions during the optimization step
 // even with -nostdlib -fno-builtin flags
 void *memcpy(void *dst, const void *src, uint32_t cnt);
+#else
+void *memcpy(void *dst, const void *src, __SIZE_TYPE__ cnt);
 #endif
 
 /* Convert list of u64 into bytes */
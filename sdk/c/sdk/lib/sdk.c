@@ -1,8 +1,21 @@
 #include "zkwasmsdk.h"
 
+#ifdef ZKWASM_HOST_STATS
+uint64_t zkwasm_host_calls[ZKWASM_HOST_IMPORTS];
+
+uint64_t zkwasm_host_stats(uint32_t id)
+{
+  return id < ZKWASM_HOST_IMPORTS ? zkwasm_host_calls[id] : 0;
+}
+#endif
+
 void assert(int cond)
 {
+#if defined(__wasm__)
     if (!cond) __builtin_unreachable();
+#else
+    if (!cond) __builtin_trap();
+#endif
 }
 
 #if defined(__wasm__)
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "zkwasm-native.h"
+
+struct input_queue
+{
+  uint64_t *values;
+  uint32_t len;
+  uint32_t cap;
+  uint32_t pos;
+};
+
+static struct input_queue queues[2];
+
+void zkwasm_native_input(uint32_t is_public, uint64_t value)
+{
+  struct input_queue *q = &queues[is_public != 0];
+  if (q->len == q->cap)
+  {
+    q->cap = q->cap ? q->cap * 2 : 64;
+    q->values = realloc(q->values, q->cap * sizeof(uint64_t));
+    if (!q->values)
+    {
+      fprintf(stderr, "zkwasm-native: out of memory\n");
+      abort();
+    }
+  }
+  q->values[q->len++] = value;
+}
+
+void zkwasm_native_input_bytes(uint32_t is_public, const uint8_t *bytes, uint32_t len)
+{
+  for (uint32_t i = 0; i < len; i += 8)
+  {
+    uint64_t word = 0;
+    for (uint32_t j = 0; j < 8 && i + j < len; j++)
+      word |= (uint64_t)bytes[i + j] << (8 * j);
+    zkwasm_native_input(is_public, word);
+  }
+}
+
+void zkwasm_native_rewind(void)
+{
+  queues[0].pos = 0;
+  queues[1].pos = 0;
+}
+
+void zkwasm_native_reset(void)
+{
+  for (int i = 0; i < 2; i++)
+  {
+    free(queues[i].values);
+    queues[i].values = NULL;
+    queues[i].len = queues[i].cap = queues[i].pos = 0;
+  }
+}
+
+uint64_t wasm_input(uint32_t is_public)
+{
+  struct input_queue *q = &queues[is_public != 0];
+  if (q->pos == q->len)
+  {
+    fprintf(stderr, "zkwasm-native: wasm_input: %s input exhausted\n", is_public ? "public" : "private");
+    abort();
+  }
+  return q->values[q->pos++];
+}
+
+void require(int cond)
+{
+  if (!cond)
+  {
+    fprintf(stderr, "zkwasm-native: require failed\n");
+    abort();
+  }
+}
+
+/*
+ * The foreign circuits are not emulated: pushes are counted so that a pop
+ * after a malformed push sequence is caught, pops return zero limbs.
+ */
+static uint64_t ecc_pop(const char *name, uint64_t *pushed, uint64_t stride)
+{
+  if (*pushed % stride)
+  {
+    fprintf(stderr, "zkwasm-native: %s: %llu limbs pushed, expected a multiple of %llu\n",
+            name, (unsigned long long)*pushed, (unsigned long long)stride);
+    abort();
+  }
+  *pushed = 0;
+  return 0;
+}
+
+static uint64_t bn254pair_pushed, bn254msm_pushed, blspair_pushed, blssum_pushed;
+
+void bn254pair_g1(uint64_t x) { bn254pair_pushed++; }
+void bn254pair_g2(uint64_t x) { bn254pair_pushed++; }
+uint64_t bn254pair_pop(void) { return ecc_pop("bn254pair_pop", &bn254pair_pushed, 13 + 25); }
+void bn254msm_g1(uint64_t x) { bn254msm_pushed++; }
+uint64_t bn254msm_pop(void) { return ecc_pop("bn254msm_pop", &bn254msm_pushed, 17); }
+void blspair_g1(uint64_t x) { blspair_pushed++; }
+void blspair_g2(uint64_t x) { blspair_pushed++; }
+uint64_t blspair_pop(void) { return ecc_pop("blspair_pop", &blspair_pushed, 17 + 33); }
+void blssum_g1(uint64_t x) { blssum_pushed++; }
+uint64_t blssum_pop(void) { return ecc_pop("blssum_pop", &blssum_pushed, 17); }
@@ -0,0 +1,127 @@
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Multi-buffer SHA-256 for the native build: eight messages of the same
+ * length are hashed side by side, one message per 32-bit vector lane. The
+ * lanes use the compiler's vector extensions, so the same code becomes AVX2
+ * on hosts that have it (picked at run time) and SSE2 or NEON pairs
+ * otherwise. SHA256_DigestBatch in sha256.c hashes the remainder.
+ */
+
+#define LANES 8
+
+typedef uint32_t vec __attribute__((vector_size(4 * LANES)));
+
+#define ROTR(x, n) ((x) >> (n) | (x) << (32 - (n)))
+
+static const uint32_t k256[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t h0[8] = {
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+  return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static inline void store_be32(uint8_t *p, uint32_t x)
+{
+  p[0] = x >> 24;
+  p[1] = x >> 16;
+  p[2] = x >> 8;
+  p[3] = x;
+}
+
+/* Hashes LANES messages of size bytes starting at msgs */
+static inline __attribute__((always_inline)) void sha256_lanes(uint8_t *output, const uint8_t *msgs, uint32_t size)
+{
+  uint32_t blocks = size >> 6, tail = size & 63;
+  uint32_t padded = tail < 56 ? 1 : 2;
+  uint64_t bits = (uint64_t)size << 3;
+  uint8_t pad[LANES][128];
+  vec state[8];
+
+  for (int lane = 0; lane < LANES; lane++)
+  {
+    memset(pad[lane], 0, sizeof(pad[lane]));
+    memcpy(pad[lane], msgs + lane * size + blocks * 64, tail);
+    pad[lane][tail] = 0x80;
+    for (int i = 0; i < 8; i++)
+      pad[lane][padded * 64 - 1 - i] = (uint8_t)(bits >> (8 * i));
+  }
+  for (int i = 0; i < 8; i++)
+    state[i] = (vec){ 0 } + h0[i];
+
+  for (uint32_t b = 0; b < blocks + padded; b++)
+  {
+    vec w[16];
+    for (int t = 0; t < 16; t++)
+    {
+      for (int lane = 0; lane < LANES; lane++)
+      {
+        const uint8_t *block = b < blocks ? msgs + lane * size + b * 64 : pad[lane] + (b - blocks) * 64;
+        w[t][lane] = load_be32(block + 4 * t);
+      }
+    }
+
+    vec a = state[0], b_ = state[1], c = state[2], d = state[3];
+    vec e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int t = 0; t < 64; t++)
+    {
+      if (t >= 16)
+      {
+        vec w15 = w[(t - 15) & 15], w2 = w[(t - 2) & 15];
+        w[t & 15] += (ROTR(w15, 7) ^ ROTR(w15, 18) ^ (w15 >> 3)) + w[(t - 7) & 15]
+                   + (ROTR(w2, 17) ^ ROTR(w2, 19) ^ (w2 >> 10));
+      }
+      vec t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + (g ^ (e & (f ^ g))) + k256[t] + w[t & 15];
+      vec t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b_) ^ (c & (a ^ b_)));
+      h = g, g = f, f = e, e = d + t1, d = c, c = b_, b_ = a, a = t1 + t2;
+    }
+    state[0] += a, state[1] += b_, state[2] += c, state[3] += d;
+    state[4] += e, state[5] += f, state[6] += g, state[7] += h;
+  }
+
+  for (int lane = 0; lane < LANES; lane++)
+  {
+    for (int i = 0; i < 8; i++)
+      store_be32(output + lane * 32 + 4 * i, state[i][lane]);
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2"))) static void sha256_lanes_avx2(uint8_t *output, const uint8_t *msgs, uint32_t size)
+{
+  sha256_lanes(output, msgs, size);
+}
+#endif
+
+static void sha256_lanes_generic(uint8_t *output, const uint8_t *msgs, uint32_t size)
+{
+  sha256_lanes(output, msgs, size);
+}
+
+uint32_t sha256_mb_digest(uint8_t *output, const uint8_t *msgs, uint32_t count, uint32_t size)
+{
+  void (*lanes)(uint8_t *, const uint8_t *, uint32_t) = sha256_lanes_generic;
+  uint32_t done;
+
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("avx2"))
+    lanes = sha256_lanes_avx2;
+#endif
+  for (done = 0; done + LANES <= count; done += LANES)
+    lanes(output + done * 32, msgs + done * size, size);
+  return done;
+}
@@ -0,0 +1,26 @@
+#ifndef __ZKWASM_NATIVE__
+
+#define __ZKWASM_NATIVE__
+
+#include <stdint.h>
+
+/*
+ * Native stand-ins for the zkWasm host imports, linked into libzkwasmsdk.a
+ * when the sdk is built for the host. Inputs are queued here and consumed by
+ * wasm_input() in the same order as on the zkWasm cli; require() aborts and
+ * the curve pops return zero limbs, as in tools/zkrun.
+ */
+
+/* Queue one input for wasm_input(is_public) */
+void zkwasm_native_input(uint32_t is_public, uint64_t value);
+
+/* Queue bytes as inputs, eight bytes per input, little endian (bytes-packed) */
+void zkwasm_native_input_bytes(uint32_t is_public, const uint8_t *bytes, uint32_t len);
+
+/* Rewind both queues so that the queued inputs can be read again */
+void zkwasm_native_rewind(void);
+
+/* Drop every queued input */
+void zkwasm_native_reset(void);
+
+#endif
@@ -0,0 +1,25 @@
+# Build options shared by every project Makefile, which includes this file
+# after setting SDK_DIR. Each option maps to a -D flag for both the sdk and
+# the project sources; sdk/scripts/build.sh passes SDK_CFLAGS on to the sdk.
+# Run make clean after changing one so that sdk.wasm is rebuilt with it.
+
+# HOST_STATS=1 counts every sdk host import call, see zkwasmsdk.h.
+ifneq ($(HOST_STATS),)
+SDK_CFLAGS += -DZKWASM_HOST_STATS
+endif
+# SHA256_COMPRESS=1 hashes whole blocks through the zkwasm_sha256_compress_*
+# imports instead of the per-round ones. Only for provers that provide them.
+ifneq ($(SHA256_COMPRESS),)
+SDK_CFLAGS += -DZKWASM_SHA256_COMPRESS
+endif
+# SHA512_COMPRESS=1 does the same for SHA-512 with the
+# zkwasm_sha512_compress_* imports.
+ifneq ($(SHA512_COMPRESS),)
+SDK_CFLAGS += -DZKWASM_SHA512_COMPRESS
+endif
+# KECCAKF=1 runs every Keccak-f[1600] permutation through the
+# zkwasm_keccakf_* imports instead of in the guest.
+ifneq ($(KECCAKF),)
+SDK_CFLAGS += -DZKWASM_KECCAKF
+endif
+export SDK_CFLAGS
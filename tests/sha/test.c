@@ -1,5 +1,7 @@
 #include "zkwasmsdk.h"
 #include "hash-wasm.h"
+#include "merkle.h"
+#include "hmac.h"
 #include <stdint.h>
 #include <stddef.h>
 __attribute__((visibility("default")))
@@ -9,5 +11,116 @@ int zkmain() {
     msg[0] = (uint8_t)0;
     SHA256_Digest(hash, 1, msg);
     require(hash[0]==110);
+
+    /* two contexts in progress at once: "abc" and the byte 0 again */
+    struct sha256_ctx abc, zero;
+    const uint8_t text[3] = {'a', 'b', 'c'};
+    SHA256_Init(&abc);
+    SHA256_Init(&zero);
+    SHA256_Update(&abc, 2, text);
+    SHA256_Update(&zero, 1, msg);
+    SHA256_Update(&abc, 1, text + 2);
+    SHA256_Final(&zero, hash);
+    require(hash[0]==110);
+    SHA256_Final(&abc, hash);
+    require(hash[0]==0xba && hash[31]==0xad);
+
+    /* 64-byte node hash against the generic path */
+    uint32_t left[8], right[8], node[8];
+    uint8_t both[64];
+    for (int i = 0; i < 32; i++) {
+        both[i] = ((uint8_t *)left)[i] = (uint8_t)i;
+        both[32 + i] = ((uint8_t *)right)[i] = (uint8_t)(255 - i);
+    }
+    SHA256_Digest(hash, 64, both);
+    SHA256_Hash64(node, left, right);
+    for (int i = 0; i < 32; i++) require(((uint8_t *)node)[i] == hash[i]);
+
+    /* resuming from the midstate after the first block of both[] */
+    struct sha256_ctx prefix, resumed;
+    struct sha256_midstate state;
+    uint8_t again[32];
+    SHA256_Init(&prefix);
+    SHA256_Update(&prefix, 64, both);
+    SHA256_Export(&prefix, &state);
+    SHA256_Resume(&resumed, &state);
+    SHA256_Update(&resumed, 3, text);
+    SHA256_Final(&resumed, again);
+    SHA256_Update(&prefix, 3, text);
+    SHA256_Final(&prefix, hash);
+    for (int i = 0; i < 32; i++) require(again[i] == hash[i]);
+
+    /* three 21-byte messages at once against one digest each */
+    uint8_t batch[3 * 32];
+    SHA256_DigestBatch(batch, both, 3, 21);
+    for (int m = 0; m < 3; m++) {
+        SHA256_Digest(hash, 21, both + 21 * m);
+        for (int i = 0; i < 32; i++) require(batch[32 * m + i] == hash[i]);
+    }
+
+    /* three leaves: the third is promoted, then hashed with the first pair */
+    uint32_t leaves[3 * 8], expect[8];
+    for (int i = 0; i < 8; i++) {
+        leaves[i] = left[i];
+        leaves[8 + i] = right[i];
+        leaves[16 + i] = node[i];
+    }
+    SHA256_MerkleRoot(leaves, 3);
+    SHA256_Hash64(expect, left, right);
+    SHA256_Hash64(expect, expect, node);
+    for (int i = 0; i < 8; i++) require(leaves[i] == expect[i]);
+    /* a single leaf is its own root and its proof reads no input */
+    require(SHA256_MerkleProofLength(0, 1) == 0 && SHA256_MerkleProofLength(2, 3) == 1);
+    require(SHA256_MerkleVerifyInput(node, node, 0, 1, 0));
+
+    /* RFC 4231 test case 2 and RFC 5869 test case 1 */
+    struct hmac_sha256_key jefe;
+    const char *question = "what do ya want for nothing?";
+    HMAC_SHA256_SetKey(&jefe, 4, (const uint8_t *)"Jefe");
+    HMAC_SHA256(hash, &jefe, 28, (const uint8_t *)question);
+    require(hash[0] == 0x5b && hash[31] == 0x43);
+    uint8_t ikm[22], salt[13], info[10], prk[32], okm[42];
+    for (int i = 0; i < 22; i++) ikm[i] = 0x0b;
+    for (int i = 0; i < 13; i++) salt[i] = (uint8_t)i;
+    for (int i = 0; i < 10; i++) info[i] = (uint8_t)(0xf0 + i);
+    HKDF_SHA256_Extract(prk, 13, salt, 22, ikm);
+    require(prk[0] == 0x07 && prk[31] == 0xe5);
+    HKDF_SHA256_Expand(okm, 42, prk, 10, info);
+    require(okm[0] == 0x3c && okm[41] == 0x65);
+
+    /* SHA-512 and SHA-384 of "abc" */
+    uint8_t hash512[64];
+    SHA512_Digest(hash512, 3, text);
+    require(hash512[0] == 0xdd && hash512[63] == 0x9f);
+    SHA384_Digest(hash512, 3, text);
+    require(hash512[0] == 0xcb && hash512[47] == 0xa7);
+
+    /* Keccak-256 of the empty message, then "abc" absorbed in two chunks */
+    keccak256(msg, 0, hash);
+    require(hash[0] == 0xc5 && hash[31] == 0x70);
+    struct keccak_ctx kctx;
+    Keccak_Init(&kctx, 1088, 0x01);
+    Keccak_Absorb(&kctx, 1, text);
+    Keccak_Absorb(&kctx, 2, text + 1);
+    Keccak_Squeeze(&kctx, 32, again);
+    keccak256((uint8_t *)text, 3, hash);
+    for (int i = 0; i < 32; i++) require(again[i] == hash[i]);
+    /* FIPS 202 SHA3-256 of "abc" */
+    sha3_256((uint8_t *)text, 3, hash);
+    require(hash[0] == 0x3a && hash[31] == 0x32);
+    /* 200 bytes of SHAKE128("abc"), past one 168-byte block, then again
+       squeezed 7 bytes at a time */
+    uint8_t xof[200], part[7];
+    shake128((uint8_t *)text, 3, xof, 200);
+    require(xof[0] == 0x58 && xof[199] == 0xcd);
+    SHAKE128_Init(&kctx);
+    Keccak_Absorb(&kctx, 3, text);
+    for (int done = 0; done < 200; done += 7) {
+        int size = 200 - done < 7 ? 200 - done : 7;
+        Keccak_Squeeze(&kctx, size, part);
+        for (int i = 0; i < size; i++) require(part[i] == xof[done + i]);
+    }
+    shake256((uint8_t *)text, 3, xof, 64);
+    require(xof[0] == 0x48 && xof[63] == 0xe4);
     return 0;
 }
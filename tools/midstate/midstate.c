@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zkwasmsdk.h"
+#include "hash-wasm.h"
+
+/*
+ * Prints the SHA-256 midstate of a constant message prefix as a C
+ * initializer for struct sha256_midstate, computed with the native build of
+ * the sdk. Only whole 64-byte blocks go into the midstate; the rest of the
+ * prefix is printed as a byte array for the guest to hash after
+ * SHA256_Resume.
+ */
+
+#define MAX_PREFIX (1 << 20)
+
+/* one spare byte tells a file of exactly MAX_PREFIX bytes from a longer one */
+static uint8_t prefix[MAX_PREFIX + 1];
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: midstate [--name <identifier>] --hex <hex> | --text <string> | --file <path>\n"
+        "\n"
+        "Prints the SHA-256 midstate after the whole 64-byte blocks of the prefix\n"
+        "as a struct sha256_midstate initializer, followed by the remaining bytes.\n");
+    exit(2);
+}
+
+static int hex_nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static uint32_t parse_hex(const char *hex) {
+    size_t len = strlen(hex);
+    if (len >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+        hex += 2;
+        len -= 2;
+    }
+    if (len % 2 || len / 2 > MAX_PREFIX) usage();
+    for (size_t i = 0; i < len; i += 2) {
+        int hi = hex_nibble(hex[i]), lo = hex_nibble(hex[i + 1]);
+        if (hi < 0 || lo < 0) usage();
+        prefix[i / 2] = (uint8_t)(hi << 4 | lo);
+    }
+    return len / 2;
+}
+
+static uint32_t read_prefix(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "midstate: cannot read %s\n", path);
+        exit(1);
+    }
+    size_t len = fread(prefix, 1, MAX_PREFIX + 1, f);
+    if (len > MAX_PREFIX) {
+        fprintf(stderr, "midstate: %s is longer than %d bytes\n", path, MAX_PREFIX);
+        exit(1);
+    }
+    fclose(f);
+    return len;
+}
+
+int main(int argc, char **argv) {
+    const char *name = "prefix_midstate";
+    uint32_t len = 0;
+    int have_prefix = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 == argc) usage();
+        if (strcmp(argv[i], "--name") == 0) {
+            name = argv[++i];
+            continue;
+        }
+        if (have_prefix) usage();
+        if (strcmp(argv[i], "--hex") == 0) {
+            len = parse_hex(argv[++i]);
+        } else if (strcmp(argv[i], "--text") == 0) {
+            if (strlen(argv[i + 1]) > MAX_PREFIX) usage();
+            len = strlen(argv[++i]);
+            memcpy(prefix, argv[i], len);
+        } else if (strcmp(argv[i], "--file") == 0) {
+            len = read_prefix(argv[++i]);
+        } else {
+            usage();
+        }
+        have_prefix = 1;
+    }
+    if (!have_prefix) usage();
+
+    struct sha256_ctx ctx;
+    struct sha256_midstate state;
+    uint32_t blocks = len & ~63u;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, blocks, prefix);
+    SHA256_Export(&ctx, &state);
+
+    printf("/* SHA-256 midstate after %u of the %u prefix bytes */\n", blocks, len);
+    printf("static const struct sha256_midstate %s = {\n    {", name);
+    for (int i = 0; i < 8; i++) printf("%s0x%08x", i ? ", " : "", state.hash[i]);
+    printf("},\n    %lluull};\n", (unsigned long long)state.length);
+    if (len > blocks) {
+        printf("/* hash after SHA256_Resume */\n");
+        printf("static const uint8_t %s_tail[%u] = {\n    ", name, len - blocks);
+        for (uint32_t i = blocks; i < len; i++)
+            printf("%s0x%02x", i == blocks ? "" : (i - blocks) % 12 ? ", " : ",\n    ", prefix[i]);
+        printf("};\n");
+    }
+    return 0;
+}
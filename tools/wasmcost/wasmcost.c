@@ -0,0 +1,228 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wasm.h"
+
+/*
+ * Static trace cost estimate of every function in a zkWasm image, using the
+ * same per-instruction row model as zkrun. Each instruction is counted once
+ * per pass through its enclosing code: if/else takes the dearer arm, every
+ * loop body is multiplied by its own symbolic trip count nK (numbered in
+ * order of appearance within the function) and calls to functions with a
+ * constant cost are folded in. A branch out of a block or loop only makes
+ * the real cost lower, so the estimate is an upper bound for given nK.
+ */
+
+struct text {
+    char *buf;
+    size_t len;
+    size_t cap;
+};
+
+struct estimate {
+    /* rows that do not depend on any trip count */
+    uint64_t rows;
+    /* symbolic part, as " + term" entries */
+    struct text terms;
+};
+
+struct func_cost {
+    /* 0 not visited, 1 being estimated, 2 done */
+    int state;
+    uint32_t loops;
+    uint32_t host_sites;
+    struct estimate est;
+};
+
+static struct wasm_vm vm;
+static struct func_cost *costs;
+
+static void text_printf(struct text *t, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (t->len + n + 1 > t->cap) {
+        t->cap = (t->len + n + 1) * 2;
+        t->buf = realloc(t->buf, t->cap);
+        if (!t->buf) {
+            fprintf(stderr, "wasmcost: out of memory\n");
+            exit(2);
+        }
+    }
+    va_start(ap, fmt);
+    vsnprintf(t->buf + t->len, n + 1, fmt, ap);
+    va_end(ap);
+    t->len += n;
+}
+
+/* "rows + terms", leaving out a zero constant */
+static void text_estimate(struct text *t, const struct estimate *e) {
+    if (!e->terms.len) {
+        text_printf(t, "%llu", (unsigned long long)e->rows);
+    } else if (!e->rows) {
+        text_printf(t, "%s", e->terms.buf + 3);
+    } else {
+        text_printf(t, "%llu%s", (unsigned long long)e->rows, e->terms.buf);
+    }
+}
+
+static void estimate_func(uint32_t func);
+
+/* Adds the cost of code[from, to) of func to out */
+static void estimate_range(uint32_t func, uint32_t from, uint32_t to, struct estimate *out) {
+    struct wasm_func *f = &vm.funcs[func];
+    for (uint32_t pc = from; pc < to; pc++) {
+        struct wasm_instr *ins = &f->code[pc];
+        switch (ins->op) {
+        case 0x03: { /* loop */
+            struct estimate body = { 0 };
+            uint32_t n = ++costs[func].loops;
+            estimate_range(func, pc + 1, ins->a, &body);
+            if (body.terms.len) {
+                text_printf(&out->terms, " + n%u*(", n);
+                text_estimate(&out->terms, &body);
+                text_printf(&out->terms, ")");
+            } else {
+                text_printf(&out->terms, " + n%u*%llu", n, (unsigned long long)body.rows);
+            }
+            free(body.terms.buf);
+            pc = ins->a;
+            break;
+        }
+        case 0x04: {
+            /* if: the row of the else opcode, executed when the then arm
+               ends, is counted in the then arm; an if without an else
+               costs nothing extra when it falls through */
+            struct estimate then = { 0 }, other = { 0 };
+            uint32_t mid = ins->b ? ins->b + 1 : ins->a;
+            out->rows += ins->rows;
+            estimate_range(func, pc + 1, mid, &then);
+            estimate_range(func, mid, ins->a, &other);
+            if (!then.terms.len && !other.terms.len) {
+                out->rows += then.rows > other.rows ? then.rows : other.rows;
+            } else {
+                text_printf(&out->terms, " + max(");
+                text_estimate(&out->terms, &then);
+                text_printf(&out->terms, ", ");
+                text_estimate(&out->terms, &other);
+                text_printf(&out->terms, ")");
+            }
+            free(then.terms.buf);
+            free(other.terms.buf);
+            pc = ins->a;
+            break;
+        }
+        case 0x10: /* call */
+            out->rows += ins->rows;
+            if (ins->a < vm.nimports) {
+                costs[func].host_sites++;
+                break;
+            }
+            estimate_func(ins->a);
+            if (costs[ins->a].state == 2 && !costs[ins->a].est.terms.len)
+                out->rows += costs[ins->a].est.rows;
+            else
+                text_printf(&out->terms, " + %s", wasm_func_name(&vm, ins->a));
+            break;
+        case 0x11: /* call_indirect */
+            out->rows += ins->rows;
+            text_printf(&out->terms, " + call_indirect");
+            break;
+        default:
+            out->rows += ins->rows;
+            break;
+        }
+    }
+}
+
+static void estimate_func(uint32_t func) {
+    if (costs[func].state) return;
+    costs[func].state = 1;
+    estimate_range(func, 0, vm.funcs[func].ncode, &costs[func].est);
+    costs[func].state = 2;
+}
+
+static uint8_t *read_file(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *bytes = malloc(len > 0 ? len : 1);
+    if (!bytes || fread(bytes, 1, len, f) != (size_t)len) {
+        free(bytes);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+    *size = len;
+    return bytes;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: wasmcost [--func <name>] <image.wasm>\n"
+        "\n"
+        "Estimates the zkWasm trace rows of every function without running it.\n"
+        "Loop bodies are multiplied by symbolic trip counts n1, n2, ... per function,\n"
+        "if/else takes the dearer arm and calls to constant-cost functions are folded\n"
+        "in; other callees appear by name. Takes linked images and relocatable\n"
+        "objects such as the sdk lib/*.wasm (a .wat converts back with wat2wasm).\n"
+        "Function names need an image built without --strip-all; objects carry\n"
+        "them in their linking section.\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--func") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else if (argv[i][0] == '-' || path) {
+            usage();
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) usage();
+
+    size_t size;
+    uint8_t *bytes = read_file(path, &size);
+    if (!bytes) {
+        fprintf(stderr, "wasmcost: cannot read %s\n", path);
+        return 2;
+    }
+    if (wasm_load_static(&vm, bytes, size) != WASM_OK) {
+        fprintf(stderr, "wasmcost: %s: %s\n", path, vm.error);
+        return 1;
+    }
+
+    costs = calloc(vm.nfuncs ? vm.nfuncs : 1, sizeof(struct func_cost));
+    int found = 0;
+    printf("%10s %5s %10s  %s\n", "fixed", "loops", "host sites", "function = cost");
+    for (uint32_t i = vm.nimports; i < vm.nfuncs; i++) {
+        estimate_func(i);
+        if (only && strcmp(wasm_func_name(&vm, i), only) != 0) continue;
+        struct text cost = { 0 };
+        text_estimate(&cost, &costs[i].est);
+        printf("%10llu %5u %10u  %s = %s\n", (unsigned long long)costs[i].est.rows, costs[i].loops,
+               costs[i].host_sites, wasm_func_name(&vm, i), cost.buf);
+        free(cost.buf);
+        found = 1;
+    }
+    if (only && !found) {
+        fprintf(stderr, "wasmcost: %s: no function '%s'\n", path, only);
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < vm.nfuncs; i++) free(costs[i].est.terms.buf);
+    free(costs);
+    wasm_free(&vm);
+    free(bytes);
+    return 0;
+}
@@ -0,0 +1,428 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host.h"
+
+/*
+ * Host side of the imports declared under sdk/c. Semantics follow the zkWasm
+ * host functions: wasm_input(1) pops the public queue, wasm_input(0) the
+ * private one, and the foreign circuits are fed one u64 limb per call.
+ */
+
+#define ROTR32(x, n) ((x) >> (n) | ((x) << (32 - (n))))
+#define ROTR64(x, n) ((x) >> (n) | ((x) << (64 - (n))))
+
+static struct host_state *state(struct wasm_vm *vm) {
+    return (struct host_state *)vm->host_data;
+}
+
+static void queue_push(struct host_queue *q, uint64_t v) {
+    if (q->len == q->cap) {
+        q->cap = q->cap ? q->cap * 2 : 64;
+        q->values = realloc(q->values, q->cap * sizeof(uint64_t));
+        if (!q->values) {
+            fprintf(stderr, "zkrun: out of memory\n");
+            exit(2);
+        }
+    }
+    q->values[q->len++] = v;
+}
+
+static int hex_nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+int host_push_input(struct host_state *host, int is_public, const char *arg) {
+    struct host_queue *q = is_public ? &host->public_inputs : &host->private_inputs;
+    const char *colon = strrchr(arg, ':');
+    if (!colon) return -1;
+    const char *type = colon + 1;
+    size_t len = colon - arg;
+
+    if (strcmp(type, "i64") == 0) {
+        char buf[32];
+        char *end;
+        if (len == 0 || len >= sizeof(buf)) return -1;
+        memcpy(buf, arg, len);
+        buf[len] = 0;
+        uint64_t v = strtoull(buf, &end, 0);
+        if (*end) return -1;
+        queue_push(q, v);
+        return 0;
+    }
+
+    int packed = strcmp(type, "bytes-packed") == 0;
+    if (!packed && strcmp(type, "bytes") != 0) return -1;
+    if (len >= 2 && arg[0] == '0' && (arg[1] == 'x' || arg[1] == 'X')) {
+        arg += 2;
+        len -= 2;
+    }
+    if (len % 2) return -1;
+
+    uint64_t word = 0;
+    size_t n = 0;
+    for (size_t i = 0; i < len; i += 2) {
+        int hi = hex_nibble(arg[i]), lo = hex_nibble(arg[i + 1]);
+        if (hi < 0 || lo < 0) return -1;
+        uint64_t byte = (uint64_t)(hi << 4 | lo);
+        if (!packed) {
+            queue_push(q, byte);
+            continue;
+        }
+        /* bytes-packed: eight bytes per input, little endian */
+        word |= byte << (8 * n);
+        if (++n == 8) {
+            queue_push(q, word);
+            word = 0;
+            n = 0;
+        }
+    }
+    if (n) queue_push(q, word);
+    return 0;
+}
+
+static int host_wasm_input(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    int is_public = (uint32_t)args[0] != 0;
+    struct host_queue *q = is_public ? &state(vm)->public_inputs : &state(vm)->private_inputs;
+    if (q->pos == q->len)
+        return wasm_trap(vm, "wasm_input: %s input exhausted", is_public ? "public" : "private");
+    *result = q->values[q->pos++];
+    return 0;
+}
+
+static int host_require(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    if (!(uint32_t)args[0]) return wasm_trap(vm, "require failed");
+    return 0;
+}
+
+static int host_sha256_ch(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    uint32_t x = args[0], y = args[1], z = args[2];
+    *result = z ^ (x & (y ^ z));
+    return 0;
+}
+
+static int host_sha256_maj(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    uint32_t x = args[0], y = args[1], z = args[2];
+    *result = (x & y) ^ (z & (x ^ y));
+    return 0;
+}
+
+static int host_sha256_lsigma0(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    uint32_t x = args[0];
+    *result = ROTR32(x, 2) ^ ROTR32(x, 13) ^ ROTR32(x, 22);
+    return 0;
+}
+
+static int host_sha256_lsigma1(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    uint32_t x = args[0];
+    *result = ROTR32(x, 6) ^ ROTR32(x, 11) ^ ROTR32(x, 25);
+    return 0;
+}
+
+static int host_sha256_ssigma0(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    uint32_t x = args[0];
+    *result = ROTR32(x, 7) ^ ROTR32(x, 18) ^ (x >> 3);
+    return 0;
+}
+
+static int host_sha256_ssigma1(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    uint32_t x = args[0];
+    *result = ROTR32(x, 17) ^ ROTR32(x, 19) ^ (x >> 10);
+    return 0;
+}
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/* One SHA-256 compression over the pushed words, see sdk/c/hash/lib/sha256.c */
+static void sha256_compress(uint64_t words[12]) {
+    uint32_t h[8], w[64];
+    for (int i = 0; i < 4; i++) {
+        h[2 * i] = (uint32_t)words[i];
+        h[2 * i + 1] = (uint32_t)(words[i] >> 32);
+    }
+    /* block bytes in memory order, big endian words */
+    for (int i = 0; i < 16; i++) {
+        uint64_t v = words[4 + i / 2] >> (i % 2 * 32);
+        uint32_t x = (uint32_t)v;
+        w[i] = x >> 24 | (x >> 8 & 0xff00) | (x << 8 & 0xff0000) | x << 24;
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = hh + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25)) + (g ^ (e & (f ^ g))) + sha256_k[i] + w[i];
+        uint32_t t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22)) + ((a & b) ^ (c & (a ^ b)));
+        hh = g, g = f, f = e, e = d + t1, d = c, c = b, b = a, a = t1 + t2;
+    }
+    h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e, h[5] += f, h[6] += g, h[7] += hh;
+    for (int i = 0; i < 4; i++) words[i] = h[2 * i] | (uint64_t)h[2 * i + 1] << 32;
+}
+
+static int host_sha256_compress_push(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    struct host_state *host = state(vm);
+    if (host->sha256_popped)
+        return wasm_trap(vm, "zkwasm_sha256_compress_push: %u of 4 state words still to pop", 4 - host->sha256_popped);
+    if (host->sha256_pushed == 12)
+        return wasm_trap(vm, "zkwasm_sha256_compress_push: more than 12 words pushed");
+    host->sha256_words[host->sha256_pushed++] = args[0];
+    return 0;
+}
+
+static int host_sha256_compress_pop(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    struct host_state *host = state(vm);
+    if (host->sha256_pushed != 12)
+        return wasm_trap(vm, "zkwasm_sha256_compress_pop: %u words pushed, expected 12", host->sha256_pushed);
+    if (host->sha256_popped == 0) sha256_compress(host->sha256_words);
+    *result = host->sha256_words[host->sha256_popped++];
+    if (host->sha256_popped == 4) host->sha256_pushed = host->sha256_popped = 0;
+    return 0;
+}
+
+static const uint64_t sha512_k[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+/* One SHA-512 compression over the pushed words, see sdk/c/hash/lib/sha512.c */
+static void sha512_compress(uint64_t words[24]) {
+    uint64_t h[8], w[80];
+    for (int i = 0; i < 8; i++) h[i] = words[i];
+    /* block bytes in memory order, big endian words */
+    for (int i = 0; i < 16; i++) w[i] = __builtin_bswap64(words[8 + i]);
+    for (int i = 16; i < 80; i++) {
+        uint64_t s0 = ROTR64(w[i - 15], 1) ^ ROTR64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+        uint64_t s1 = ROTR64(w[i - 2], 19) ^ ROTR64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint64_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+    for (int i = 0; i < 80; i++) {
+        uint64_t t1 = hh + (ROTR64(e, 14) ^ ROTR64(e, 18) ^ ROTR64(e, 41)) + (g ^ (e & (f ^ g))) + sha512_k[i] + w[i];
+        uint64_t t2 = (ROTR64(a, 28) ^ ROTR64(a, 34) ^ ROTR64(a, 39)) + ((a & b) ^ (c & (a ^ b)));
+        hh = g, g = f, f = e, e = d + t1, d = c, c = b, b = a, a = t1 + t2;
+    }
+    h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e, h[5] += f, h[6] += g, h[7] += hh;
+    for (int i = 0; i < 8; i++) words[i] = h[i];
+}
+
+static int host_sha512_compress_push(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    struct host_state *host = state(vm);
+    if (host->sha512_popped)
+        return wasm_trap(vm, "zkwasm_sha512_compress_push: %u of 8 state words still to pop", 8 - host->sha512_popped);
+    if (host->sha512_pushed == 24)
+        return wasm_trap(vm, "zkwasm_sha512_compress_push: more than 24 words pushed");
+    host->sha512_words[host->sha512_pushed++] = args[0];
+    return 0;
+}
+
+static int host_sha512_compress_pop(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    struct host_state *host = state(vm);
+    if (host->sha512_pushed != 24)
+        return wasm_trap(vm, "zkwasm_sha512_compress_pop: %u words pushed, expected 24", host->sha512_pushed);
+    if (host->sha512_popped == 0) sha512_compress(host->sha512_words);
+    *result = host->sha512_words[host->sha512_popped++];
+    if (host->sha512_popped == 8) host->sha512_pushed = host->sha512_popped = 0;
+    return 0;
+}
+
+static const uint64_t keccakf_rc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+/* rotation offsets of lane x + 5y */
+static const int keccakf_rotation[25] = {
+    0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43, 25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14,
+};
+
+/* Keccak-f[1600] over the pushed lanes, see sdk/c/hash/lib/keccak.c */
+static void keccakf(uint64_t a[25]) {
+    for (int round = 0; round < 24; round++) {
+        uint64_t c[5], b[25];
+        for (int x = 0; x < 5; x++) c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];
+        for (int x = 0; x < 5; x++) {
+            uint64_t d = c[(x + 4) % 5] ^ ROTR64(c[(x + 1) % 5], 63);
+            for (int y = 0; y < 5; y++) a[x + 5 * y] ^= d;
+        }
+        /* rho and pi */
+        for (int y = 0; y < 5; y++) {
+            for (int x = 0; x < 5; x++) {
+                int r = keccakf_rotation[x + 5 * y];
+                b[y + 5 * ((2 * x + 3 * y) % 5)] = r ? ROTR64(a[x + 5 * y], 64 - r) : a[x + 5 * y];
+            }
+        }
+        /* chi and iota */
+        for (int y = 0; y < 5; y++) {
+            for (int x = 0; x < 5; x++)
+                a[x + 5 * y] = b[x + 5 * y] ^ (~b[(x + 1) % 5 + 5 * y] & b[(x + 2) % 5 + 5 * y]);
+        }
+        a[0] ^= keccakf_rc[round];
+    }
+}
+
+static int host_keccakf_push(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    struct host_state *host = state(vm);
+    if (host->keccakf_popped)
+        return wasm_trap(vm, "zkwasm_keccakf_push: %u of 25 lanes still to pop", 25 - host->keccakf_popped);
+    if (host->keccakf_pushed == 25)
+        return wasm_trap(vm, "zkwasm_keccakf_push: more than 25 lanes pushed");
+    host->keccakf_lanes[host->keccakf_pushed++] = args[0];
+    return 0;
+}
+
+static int host_keccakf_pop(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {
+    struct host_state *host = state(vm);
+    if (host->keccakf_pushed != 25)
+        return wasm_trap(vm, "zkwasm_keccakf_pop: %u lanes pushed, expected 25", host->keccakf_pushed);
+    if (host->keccakf_popped == 0) keccakf(host->keccakf_lanes);
+    *result = host->keccakf_lanes[host->keccakf_popped++];
+    if (host->keccakf_popped == 25) host->keccakf_pushed = host->keccakf_popped = 0;
+    return 0;
+}
+
+/*
+ * The curve arithmetic itself is not emulated: pushes are accepted and
+ * checked for the expected limb layout, pops return zero limbs. Instruction
+ * counts on the guest side do not depend on the popped values for any
+ * routine in the SDK.
+ */
+static int ecc_pop(struct wasm_vm *vm, const char *name, uint64_t *pushed, uint64_t stride, uint64_t *result) {
+    struct host_state *host = state(vm);
+    if (*pushed % stride)
+        return wasm_trap(vm, "%s: %llu limbs pushed, expected a multiple of %llu",
+                         name, (unsigned long long)*pushed, (unsigned long long)stride);
+    if (!host->ecc_warned) {
+        fprintf(stderr, "zkrun: %s: curve operations are not emulated, popping zero limbs\n", name);
+        host->ecc_warned = 1;
+    }
+    *pushed = 0;
+    *result = 0;
+    return 0;
+}
+
+#define ECC_PUSH(fn, counter)                                                                  \
+    static int host_##fn(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {         \
+        state(vm)->counter++;                                                                  \
+        return 0;                                                                              \
+    }
+#define ECC_POP(fn, counter, stride)                                                           \
+    static int host_##fn(struct wasm_vm *vm, const uint64_t *args, uint64_t *result) {         \
+        return ecc_pop(vm, #fn, &state(vm)->counter, stride, result);                          \
+    }
+
+/* limbs per input, see sdk/c/ecc/lib */
+ECC_PUSH(bn254pair_g1, bn254pair_pushed)
+ECC_PUSH(bn254pair_g2, bn254pair_pushed)
+ECC_POP(bn254pair_pop, bn254pair_pushed, 13 + 25)
+ECC_PUSH(bn254msm_g1, bn254msm_pushed)
+ECC_POP(bn254msm_pop, bn254msm_pushed, 17)
+ECC_PUSH(blspair_g1, blspair_pushed)
+ECC_PUSH(blspair_g2, blspair_pushed)
+ECC_POP(blspair_pop, blspair_pushed, 17 + 33)
+ECC_PUSH(blssum_g1, blssum_pushed)
+ECC_POP(blssum_pop, blssum_pushed, 17)
+
+struct host_import {
+    const char *name;
+    /* parameter types, then ':' and the result type; i = i32, I = i64 */
+    const char *signature;
+    wasm_host_fn fn;
+};
+
+static const struct host_import imports[] = {
+    { "wasm_input", "i:I", host_wasm_input },
+    { "require", "i:", host_require },
+    { "zkwasm_sha256_ch", "iii:i", host_sha256_ch },
+    { "zkwasm_sha256_maj", "iii:i", host_sha256_maj },
+    { "zkwasm_sha256_lsigma0", "i:i", host_sha256_lsigma0 },
+    { "zkwasm_sha256_lsigma1", "i:i", host_sha256_lsigma1 },
+    { "zkwasm_sha256_ssigma0", "i:i", host_sha256_ssigma0 },
+    { "zkwasm_sha256_ssigma1", "i:i", host_sha256_ssigma1 },
+    { "zkwasm_sha256_compress_push", "I:", host_sha256_compress_push },
+    { "zkwasm_sha256_compress_pop", ":I", host_sha256_compress_pop },
+    { "zkwasm_sha512_compress_push", "I:", host_sha512_compress_push },
+    { "zkwasm_sha512_compress_pop", ":I", host_sha512_compress_pop },
+    { "zkwasm_keccakf_push", "I:", host_keccakf_push },
+    { "zkwasm_keccakf_pop", ":I", host_keccakf_pop },
+    { "bn254pair_g1", "I:", host_bn254pair_g1 },
+    { "bn254pair_g2", "I:", host_bn254pair_g2 },
+    { "bn254pair_pop", ":I", host_bn254pair_pop },
+    { "bn254msm_g1", "I:", host_bn254msm_g1 },
+    { "bn254msm_pop", ":I", host_bn254msm_pop },
+    { "blspair_g1", "I:", host_blspair_g1 },
+    { "blspair_g2", "I:", host_blspair_g2 },
+    { "blspair_pop", ":I", host_blspair_pop },
+    { "blssum_g1", "I:", host_blssum_g1 },
+    { "blssum_pop", ":I", host_blssum_pop },
+};
+
+static int signature_matches(const struct wasm_functype *t, const char *signature) {
+    char buf[2 * WASM_MAX_PARAMS + 2];
+    size_t n = 0;
+    for (uint32_t i = 0; i < t->nparams; i++) buf[n++] = t->params[i] == WASM_I64 ? 'I' : 'i';
+    buf[n++] = ':';
+    for (uint32_t i = 0; i < t->nresults; i++) buf[n++] = t->results[i] == WASM_I64 ? 'I' : 'i';
+    buf[n] = 0;
+    return strcmp(buf, signature) == 0;
+}
+
+int host_link(struct wasm_vm *vm, struct host_state *host) {
+    vm->host_data = host;
+    for (uint32_t i = 0; i < vm->nimports; i++) {
+        struct wasm_func *f = &vm->funcs[i];
+        if (strcmp(f->module, "env") != 0) continue;
+        for (size_t j = 0; j < sizeof(imports) / sizeof(imports[0]); j++) {
+            if (strcmp(f->field, imports[j].name) != 0) continue;
+            if (!signature_matches(&vm->types[f->type], imports[j].signature)) {
+                snprintf(vm->error, sizeof(vm->error), "import %s has an unexpected signature", f->field);
+                return WASM_ERR_LINK;
+            }
+            f->host = imports[j].fn;
+            break;
+        }
+    }
+    return WASM_OK;
+}
+
+void host_free(struct host_state *host) {
+    free(host->public_inputs.values);
+    free(host->private_inputs.values);
+    memset(host, 0, sizeof(*host));
+}
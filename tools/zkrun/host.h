@@ -0,0 +1,45 @@
+#ifndef __ZKRUN_HOST__
+
+#define __ZKRUN_HOST__
+
+#include "wasm.h"
+
+struct host_queue {
+    uint64_t *values;
+    size_t len;
+    size_t cap;
+    size_t pos;
+};
+
+struct host_state {
+    struct host_queue public_inputs;
+    struct host_queue private_inputs;
+    /* limbs pushed to each foreign circuit since its last pop sequence */
+    uint64_t bn254pair_pushed;
+    uint64_t bn254msm_pushed;
+    uint64_t blspair_pushed;
+    uint64_t blssum_pushed;
+    int ecc_warned;
+    /* zkwasm_sha256_compress_*: 4 state and 8 block words in, 4 state words out */
+    uint64_t sha256_words[12];
+    uint32_t sha256_pushed;
+    uint32_t sha256_popped;
+    /* zkwasm_sha512_compress_*: 8 state and 16 block words in, 8 state words out */
+    uint64_t sha512_words[24];
+    uint32_t sha512_pushed;
+    uint32_t sha512_popped;
+    /* zkwasm_keccakf_*: 25 lanes in, 25 permuted lanes out */
+    uint64_t keccakf_lanes[25];
+    uint32_t keccakf_pushed;
+    uint32_t keccakf_popped;
+};
+
+/* Parses "<value>:<type>" with type one of i64, bytes, bytes-packed */
+int host_push_input(struct host_state *host, int is_public, const char *arg);
+
+/* Binds every import of the module that the SDK declares */
+int host_link(struct wasm_vm *vm, struct host_state *host);
+
+void host_free(struct host_state *host);
+
+#endif
@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wasm.h"
+#include "host.h"
+#include "profile.h"
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: zkrun [options] <image.wasm>\n"
+        "\n"
+        "Runs a zkWasm image locally and reports the executed instruction count.\n"
+        "\n"
+        "  --public <value>:<type>   append to the public input queue (wasm_input(1))\n"
+        "  --private <value>:<type>  append to the private input queue (wasm_input(0))\n"
+        "  --entry <name>            exported function to run (default: zkmain)\n"
+        "  --profile <file>          write per-call-path instruction counts in collapsed\n"
+        "                            stack format and print a per-function summary\n"
+        "\n"
+        "Besides the instruction and host call counts, zkrun reports the static data\n"
+        "size, the peak stack and heap use, the memory these need and the memory\n"
+        "the image declares. A stack that grows into the static data traps.\n"
+        "\n"
+        "Input types are i64, bytes (one input per byte) and bytes-packed\n"
+        "(eight bytes per input, little endian), as accepted by the zkWasm cli.\n"
+        "Profiles need function names, so build the image without --strip-all.\n");
+    exit(2);
+}
+
+static uint8_t *read_file(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *bytes = malloc(len > 0 ? len : 1);
+    if (!bytes || fread(bytes, 1, len, f) != (size_t)len) {
+        free(bytes);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+    *size = len;
+    return bytes;
+}
+
+static void backtrace(struct wasm_vm *vm) {
+    for (uint32_t i = vm->depth; i > 0; i--)
+        fprintf(stderr, "  at %s\n", wasm_func_name(vm, vm->frames[i - 1].func));
+}
+
+/* Order of enum zkwasm_host_import in zkwasmsdk.h */
+static const char *guest_counters[] = {
+    "wasm_input", "require",
+    "zkwasm_sha256_ch", "zkwasm_sha256_maj",
+    "zkwasm_sha256_lsigma0", "zkwasm_sha256_lsigma1",
+    "zkwasm_sha256_ssigma0", "zkwasm_sha256_ssigma1",
+    "bn254pair_g1", "bn254pair_g2", "bn254pair_pop",
+    "bn254msm_g1", "bn254msm_pop",
+    "blspair_g1", "blspair_g2", "blspair_pop",
+    "blssum_g1", "blssum_pop",
+    "zkwasm_sha256_compress_push", "zkwasm_sha256_compress_pop",
+    "zkwasm_sha512_compress_push", "zkwasm_sha512_compress_pop",
+    "zkwasm_keccakf_push", "zkwasm_keccakf_pop",
+};
+
+/* Counters kept by an sdk built with -DZKWASM_HOST_STATS */
+static void report_guest_counters(struct wasm_vm *vm) {
+    int func = wasm_find_export(vm, "zkwasm_host_stats", 0);
+    if (func < 0) return;
+    /* keep the accessor calls out of the counts and the profile */
+    uint64_t instructions = vm->instructions;
+    struct wasm_tracer tracer = vm->tracer;
+    memset(&vm->tracer, 0, sizeof(vm->tracer));
+    for (uint32_t i = 0; i < sizeof(guest_counters) / sizeof(guest_counters[0]); i++) {
+        uint64_t id = i, count = 0;
+        if (wasm_invoke(vm, func, &id, &count) != WASM_OK) break;
+        if (count) printf("guest.%s: %llu\n", guest_counters[i], (unsigned long long)count);
+    }
+    vm->instructions = instructions;
+    vm->tracer = tracer;
+}
+
+static void report(struct wasm_vm *vm) {
+    uint64_t host_calls = 0;
+    for (uint32_t i = 0; i < vm->nimports; i++) host_calls += vm->funcs[i].calls;
+
+    printf("instructions: %llu\n", (unsigned long long)vm->instructions);
+    uint32_t stack_bytes = vm->stack_global >= 0 ? vm->stack_base - vm->stack_low : 0;
+    uint64_t heap_bytes = vm->store_high > vm->heap_base ? vm->store_high - vm->heap_base : 0;
+    printf("static_bytes: %u\n", vm->data_end);
+    if (vm->stack_global >= 0)
+        printf("stack_bytes: %u\n", stack_bytes);
+    printf("heap_bytes: %llu\n", (unsigned long long)heap_bytes);
+    /* smallest memory with the stack region shrunk to what was used */
+    printf("memory_min: %llu\n", (unsigned long long)(vm->data_end + stack_bytes + heap_bytes));
+    printf("memory_bytes: %llu\n", (unsigned long long)vm->pages * WASM_PAGE_SIZE);
+    printf("host_calls: %llu\n", (unsigned long long)host_calls);
+    for (uint32_t i = 0; i < vm->nimports; i++) {
+        if (vm->funcs[i].calls)
+            printf("host.%s: %llu\n", vm->funcs[i].field, (unsigned long long)vm->funcs[i].calls);
+    }
+}
+
+int main(int argc, char **argv) {
+    struct host_state host;
+    struct wasm_vm vm;
+    const char *entry = "zkmain";
+    const char *path = NULL;
+    const char *profile_path = NULL;
+    struct profile prof;
+    int err;
+
+    memset(&host, 0, sizeof(host));
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--public") == 0 || strcmp(argv[i], "--private") == 0) && i + 1 < argc) {
+            int is_public = argv[i][2] == 'p' && argv[i][3] == 'u';
+            if (host_push_input(&host, is_public, argv[i + 1]) != 0) {
+                fprintf(stderr, "zkrun: bad input '%s'\n", argv[i + 1]);
+                return 2;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--entry") == 0 && i + 1 < argc) {
+            entry = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (argv[i][0] == '-' || path) {
+            usage();
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) usage();
+
+    size_t size;
+    uint8_t *bytes = read_file(path, &size);
+    if (!bytes) {
+        fprintf(stderr, "zkrun: cannot read %s\n", path);
+        return 2;
+    }
+
+    if ((err = wasm_load(&vm, bytes, size)) != WASM_OK
+        || (err = host_link(&vm, &host)) != WASM_OK
+        || (err = wasm_instantiate(&vm)) != WASM_OK) {
+        fprintf(stderr, "zkrun: %s: %s\n", path, vm.error);
+        if (err == WASM_ERR_TRAP) backtrace(&vm);
+        return 1;
+    }
+
+    int func = wasm_find_export(&vm, entry, 0);
+    if (func < 0) {
+        fprintf(stderr, "zkrun: %s: no exported function '%s'\n", path, entry);
+        return 1;
+    }
+    struct wasm_functype *t = &vm.types[vm.funcs[func].type];
+    if (t->nparams != 0 || t->nresults > 1) {
+        fprintf(stderr, "zkrun: %s: '%s' must take no arguments\n", path, entry);
+        return 1;
+    }
+
+    if (profile_path) profile_attach(&prof, &vm);
+
+    uint64_t result = 0;
+    err = wasm_invoke(&vm, func, NULL, &result);
+    if (err != WASM_OK) {
+        fprintf(stderr, "zkrun: trap: %s\n", vm.error);
+        backtrace(&vm);
+    } else if (t->nresults) {
+        printf("result: %lld\n", (long long)(t->results[0] == WASM_I32 ? (int32_t)result : (int64_t)result));
+    }
+    report(&vm);
+    if (err == WASM_OK) report_guest_counters(&vm);
+
+    if (profile_path) {
+        FILE *out = fopen(profile_path, "w");
+        profile_finish(&prof, &vm);
+        if (!out) {
+            fprintf(stderr, "zkrun: cannot write %s\n", profile_path);
+            err = WASM_ERR_LINK;
+        } else {
+            profile_write_folded(&prof, &vm, out);
+            fclose(out);
+            printf("\n");
+            profile_write_summary(&prof, &vm, stdout);
+        }
+        profile_free(&prof);
+    }
+
+    wasm_free(&vm);
+    host_free(&host);
+    free(bytes);
+    return err == WASM_OK ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+
+#define PROFILE_ROOT 0
+#define NO_NODE UINT32_MAX
+
+static uint32_t child(struct profile *prof, uint32_t parent, uint32_t func) {
+    for (uint32_t n = prof->nodes[parent].first_child; n != NO_NODE; n = prof->nodes[n].next_sibling) {
+        if (prof->nodes[n].func == func) return n;
+    }
+    if (prof->nnodes == prof->cap) {
+        prof->cap *= 2;
+        prof->nodes = realloc(prof->nodes, prof->cap * sizeof(struct profile_node));
+        if (!prof->nodes) {
+            fprintf(stderr, "zkrun: out of memory\n");
+            exit(2);
+        }
+    }
+    uint32_t n = prof->nnodes++;
+    prof->nodes[n].func = func;
+    prof->nodes[n].parent = parent;
+    prof->nodes[n].first_child = NO_NODE;
+    prof->nodes[n].next_sibling = prof->nodes[parent].first_child;
+    prof->nodes[n].self = 0;
+    prof->nodes[parent].first_child = n;
+    return n;
+}
+
+static void charge(struct profile *prof, struct wasm_vm *vm) {
+    prof->nodes[prof->current].self += vm->instructions - prof->mark;
+    prof->mark = vm->instructions;
+}
+
+static void on_enter(struct wasm_vm *vm, uint32_t func) {
+    struct profile *prof = vm->tracer.data;
+    charge(prof, vm);
+    prof->current = child(prof, prof->current, func);
+    if (vm->funcs[func].host) {
+        /* move the call instruction from the caller to the import frame */
+        prof->nodes[prof->nodes[prof->current].parent].self--;
+        prof->nodes[prof->current].self++;
+    }
+}
+
+static void on_leave(struct wasm_vm *vm, uint32_t func) {
+    struct profile *prof = vm->tracer.data;
+    charge(prof, vm);
+    if (prof->current != PROFILE_ROOT) prof->current = prof->nodes[prof->current].parent;
+}
+
+void profile_attach(struct profile *prof, struct wasm_vm *vm) {
+    memset(prof, 0, sizeof(*prof));
+    prof->cap = 256;
+    prof->nodes = calloc(prof->cap, sizeof(struct profile_node));
+    prof->nodes[PROFILE_ROOT].func = NO_NODE;
+    prof->nodes[PROFILE_ROOT].parent = NO_NODE;
+    prof->nodes[PROFILE_ROOT].first_child = NO_NODE;
+    prof->nodes[PROFILE_ROOT].next_sibling = NO_NODE;
+    prof->nnodes = 1;
+    prof->current = PROFILE_ROOT;
+    prof->mark = vm->instructions;
+    vm->tracer.enter = on_enter;
+    vm->tracer.leave = on_leave;
+    vm->tracer.data = prof;
+}
+
+void profile_finish(struct profile *prof, struct wasm_vm *vm) {
+    charge(prof, vm);
+}
+
+static void write_path(struct profile *prof, struct wasm_vm *vm, uint32_t node, FILE *out) {
+    uint32_t parent = prof->nodes[node].parent;
+    if (parent != PROFILE_ROOT) {
+        write_path(prof, vm, parent, out);
+        fputc(';', out);
+    }
+    fputs(wasm_func_name(vm, prof->nodes[node].func), out);
+}
+
+void profile_write_folded(struct profile *prof, struct wasm_vm *vm, FILE *out) {
+    for (uint32_t n = 1; n < prof->nnodes; n++) {
+        if (!prof->nodes[n].self) continue;
+        write_path(prof, vm, n, out);
+        fprintf(out, " %llu\n", (unsigned long long)prof->nodes[n].self);
+    }
+}
+
+struct profile_row {
+    uint32_t func;
+    uint64_t self;
+    uint64_t host_calls;
+};
+
+static int by_self(const void *a, const void *b) {
+    const struct profile_row *x = a, *y = b;
+    if (x->self != y->self) return x->self < y->self ? 1 : -1;
+    return x->func < y->func ? -1 : x->func > y->func;
+}
+
+void profile_write_summary(struct profile *prof, struct wasm_vm *vm, FILE *out) {
+    struct profile_row *rows = calloc(vm->nfuncs ? vm->nfuncs : 1, sizeof(struct profile_row));
+    uint64_t total = vm->instructions ? vm->instructions : 1;
+
+    for (uint32_t i = 0; i < vm->nfuncs; i++) rows[i].func = i;
+    for (uint32_t n = 1; n < prof->nnodes; n++) {
+        struct profile_node *node = &prof->nodes[n];
+        if (vm->funcs[node->func].host) {
+            if (node->parent != PROFILE_ROOT) rows[prof->nodes[node->parent].func].host_calls += node->self;
+        } else {
+            rows[node->func].self += node->self;
+        }
+    }
+    qsort(rows, vm->nfuncs, sizeof(struct profile_row), by_self);
+
+    fprintf(out, "%12s %7s %10s %11s  %s\n", "self", "%", "calls", "host calls", "function");
+    for (uint32_t i = 0; i < vm->nfuncs; i++) {
+        struct profile_row *row = &rows[i];
+        if (vm->funcs[row->func].host || (!row->self && !vm->funcs[row->func].calls)) continue;
+        fprintf(out, "%12llu %6.2f%% %10llu %11llu  %s\n",
+                (unsigned long long)row->self, 100.0 * row->self / total,
+                (unsigned long long)vm->funcs[row->func].calls,
+                (unsigned long long)row->host_calls, wasm_func_name(vm, row->func));
+    }
+    free(rows);
+}
+
+void profile_free(struct profile *prof) {
+    free(prof->nodes);
+    memset(prof, 0, sizeof(*prof));
+}
@@ -0,0 +1,41 @@
+#ifndef __ZKRUN_PROFILE__
+
+#define __ZKRUN_PROFILE__
+
+#include <stdio.h>
+
+#include "wasm.h"
+
+/*
+ * Call-tree profiler. Every executed instruction is charged to the function
+ * on top of the call stack; the call instruction of a host import is charged
+ * to a leaf frame named after the import, so host calls show up in the
+ * flamegraph with a weight equal to their call count.
+ */
+struct profile_node {
+    uint32_t func;
+    uint32_t parent;
+    uint32_t first_child;
+    uint32_t next_sibling;
+    uint64_t self;
+};
+
+struct profile {
+    struct profile_node *nodes;
+    uint32_t nnodes;
+    uint32_t cap;
+    uint32_t current;
+    uint64_t mark;
+};
+
+void profile_attach(struct profile *prof, struct wasm_vm *vm);
+void profile_finish(struct profile *prof, struct wasm_vm *vm);
+
+/* One "caller;callee count" line per call path, as read by flamegraph.pl */
+void profile_write_folded(struct profile *prof, struct wasm_vm *vm, FILE *out);
+/* Flat per-function table sorted by self instructions */
+void profile_write_summary(struct profile *prof, struct wasm_vm *vm, FILE *out);
+
+void profile_free(struct profile *prof);
+
+#endif
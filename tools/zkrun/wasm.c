@@ -0,0 +1,1168 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wasm.h"
+
+/*
+ * Loader and interpreter for the integer subset of WebAssembly that zkWasm
+ * accepts. Floating point, SIMD and bulk memory are rejected at load time so
+ * that an image which runs here also has a chance of being proven.
+ */
+
+struct reader {
+    const uint8_t *p;
+    const uint8_t *end;
+    struct wasm_vm *vm;
+};
+
+static int fail(struct wasm_vm *vm, int code, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(vm->error, sizeof(vm->error), fmt, ap);
+    va_end(ap);
+    return code;
+}
+
+int wasm_trap(struct wasm_vm *vm, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(vm->error, sizeof(vm->error), fmt, ap);
+    va_end(ap);
+    return WASM_ERR_TRAP;
+}
+
+static void *xcalloc(size_t n, size_t size) {
+    void *p = calloc(n ? n : 1, size);
+    if (!p) {
+        fprintf(stderr, "zkrun: out of memory\n");
+        exit(2);
+    }
+    return p;
+}
+
+static int read_u8(struct reader *r, uint8_t *out) {
+    *out = 0;
+    if (r->p >= r->end) return fail(r->vm, WASM_ERR_MALFORMED, "unexpected end of module");
+    *out = *r->p++;
+    return WASM_OK;
+}
+
+static int read_leb(struct reader *r, int bits, int sign, uint64_t *out) {
+    uint64_t result = 0;
+    int shift = 0;
+    uint8_t byte;
+    *out = 0;
+    do {
+        if (r->p >= r->end || shift >= bits + 7)
+            return fail(r->vm, WASM_ERR_MALFORMED, "malformed LEB128 integer");
+        byte = *r->p++;
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    if (sign && shift < 64 && (byte & 0x40))
+        result |= ~(uint64_t)0 << shift;
+    *out = result;
+    return WASM_OK;
+}
+
+static int read_u32(struct reader *r, uint32_t *out) {
+    uint64_t v;
+    int err = read_leb(r, 32, 0, &v);
+    *out = (uint32_t)v;
+    return err;
+}
+
+static int read_name(struct reader *r, char **out) {
+    uint32_t len;
+    int err = read_u32(r, &len);
+    if (err) return err;
+    if ((size_t)(r->end - r->p) < len) return fail(r->vm, WASM_ERR_MALFORMED, "name out of bounds");
+    *out = xcalloc(len + 1, 1);
+    memcpy(*out, r->p, len);
+    r->p += len;
+    return WASM_OK;
+}
+
+#define TRY(x) do { int __err = (x); if (__err) return __err; } while (0)
+
+static int read_valtype(struct reader *r, uint8_t *out) {
+    TRY(read_u8(r, out));
+    if (*out != WASM_I32 && *out != WASM_I64)
+        return fail(r->vm, WASM_ERR_UNSUPPORTED, "value type 0x%02x is not supported by zkWasm", *out);
+    return WASM_OK;
+}
+
+static int read_limits(struct reader *r, uint32_t *min, uint32_t *max) {
+    uint8_t flags = 0;
+    TRY(read_u8(r, &flags));
+    TRY(read_u32(r, min));
+    *max = UINT32_MAX;
+    if (flags & 1) TRY(read_u32(r, max));
+    return WASM_OK;
+}
+
+/* Constant expressions: only the forms wasm-ld emits are accepted */
+static int read_const_expr(struct reader *r, uint64_t *out) {
+    uint8_t op = 0, end = 0;
+    uint64_t v;
+    TRY(read_u8(r, &op));
+    if (op == 0x41) {
+        TRY(read_leb(r, 32, 1, &v));
+        v = (uint32_t)v;
+    } else if (op == 0x42) {
+        TRY(read_leb(r, 64, 1, &v));
+    } else if (op == 0x23) {
+        uint32_t index;
+        TRY(read_u32(r, &index));
+        if (index >= r->vm->nglobals) return fail(r->vm, WASM_ERR_MALFORMED, "global index out of range");
+        v = r->vm->globals[index].value;
+    } else {
+        return fail(r->vm, WASM_ERR_UNSUPPORTED, "unsupported constant expression opcode 0x%02x", op);
+    }
+    TRY(read_u8(r, &end));
+    if (end != 0x0b) return fail(r->vm, WASM_ERR_MALFORMED, "constant expression not terminated");
+    *out = v;
+    return WASM_OK;
+}
+
+static int parse_types(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    TRY(read_u32(r, &vm->ntypes));
+    vm->types = xcalloc(vm->ntypes, sizeof(struct wasm_functype));
+    for (uint32_t i = 0; i < vm->ntypes; i++) {
+        struct wasm_functype *t = &vm->types[i];
+        uint8_t form;
+        TRY(read_u8(r, &form));
+        if (form != 0x60) return fail(vm, WASM_ERR_MALFORMED, "bad function type form");
+        TRY(read_u32(r, &t->nparams));
+        if (t->nparams > WASM_MAX_PARAMS) return fail(vm, WASM_ERR_UNSUPPORTED, "too many parameters");
+        for (uint32_t j = 0; j < t->nparams; j++) TRY(read_valtype(r, &t->params[j]));
+        TRY(read_u32(r, &t->nresults));
+        if (t->nresults > WASM_MAX_PARAMS) return fail(vm, WASM_ERR_UNSUPPORTED, "too many results");
+        for (uint32_t j = 0; j < t->nresults; j++) TRY(read_valtype(r, &t->results[j]));
+    }
+    return WASM_OK;
+}
+
+/*
+ * Memory, table and global imports of a module loaded for static analysis.
+ * Imported globals take the first indices, so they get a zero placeholder.
+ */
+static int skip_import(struct reader *r, uint8_t kind) {
+    struct wasm_vm *vm = r->vm;
+    uint32_t max;
+    uint8_t type;
+    switch (kind) {
+    case 0x01:
+        TRY(read_u8(r, &type));
+        if (type != 0x70) return fail(vm, WASM_ERR_UNSUPPORTED, "table element type 0x%02x", type);
+        return read_limits(r, &vm->ntable, &max);
+    case 0x02:
+        return read_limits(r, &vm->pages, &vm->max_pages);
+    case 0x03: {
+        struct wasm_global *g = &vm->globals[vm->nglobals++];
+        TRY(read_valtype(r, &g->type));
+        return read_u8(r, &g->mutable);
+    }
+    default:
+        return fail(vm, WASM_ERR_MALFORMED, "bad import kind 0x%02x", kind);
+    }
+}
+
+static int parse_imports(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    uint32_t count;
+    TRY(read_u32(r, &count));
+    vm->funcs = xcalloc(count, sizeof(struct wasm_func));
+    vm->globals = xcalloc(count, sizeof(struct wasm_global));
+    for (uint32_t i = 0; i < count; i++) {
+        char *module, *field;
+        uint8_t kind;
+        TRY(read_name(r, &module));
+        TRY(read_name(r, &field));
+        TRY(read_u8(r, &kind));
+        if (kind != 0x00 && !vm->static_only)
+            return fail(vm, WASM_ERR_UNSUPPORTED, "import %s.%s: only function imports are supported", module, field);
+        if (kind != 0x00) {
+            free(module);
+            free(field);
+            TRY(skip_import(r, kind));
+            continue;
+        }
+        struct wasm_func *f = &vm->funcs[vm->nfuncs++];
+        TRY(read_u32(r, &f->type));
+        if (f->type >= vm->ntypes) return fail(vm, WASM_ERR_MALFORMED, "type index out of range");
+        f->module = module;
+        f->field = field;
+    }
+    vm->nimports = vm->nfuncs;
+    return WASM_OK;
+}
+
+static int parse_functions(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    uint32_t count;
+    TRY(read_u32(r, &count));
+    struct wasm_func *funcs = xcalloc(vm->nfuncs + count, sizeof(struct wasm_func));
+    if (vm->nfuncs) memcpy(funcs, vm->funcs, vm->nfuncs * sizeof(struct wasm_func));
+    free(vm->funcs);
+    vm->funcs = funcs;
+    for (uint32_t i = 0; i < count; i++) {
+        struct wasm_func *f = &vm->funcs[vm->nfuncs++];
+        TRY(read_u32(r, &f->type));
+        if (f->type >= vm->ntypes) return fail(vm, WASM_ERR_MALFORMED, "type index out of range");
+    }
+    return WASM_OK;
+}
+
+static int parse_table(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    uint32_t count, max;
+    uint8_t elemtype;
+    TRY(read_u32(r, &count));
+    if (count > 1) return fail(vm, WASM_ERR_UNSUPPORTED, "multiple tables");
+    if (count == 0) return WASM_OK;
+    TRY(read_u8(r, &elemtype));
+    if (elemtype != 0x70) return fail(vm, WASM_ERR_UNSUPPORTED, "table element type 0x%02x", elemtype);
+    TRY(read_limits(r, &vm->ntable, &max));
+    vm->table = xcalloc(vm->ntable, sizeof(uint32_t));
+    memset(vm->table, 0xff, vm->ntable * sizeof(uint32_t));
+    return WASM_OK;
+}
+
+static int parse_memory(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    uint32_t count;
+    TRY(read_u32(r, &count));
+    if (count > 1) return fail(vm, WASM_ERR_UNSUPPORTED, "multiple memories");
+    if (count == 0) return WASM_OK;
+    TRY(read_limits(r, &vm->pages, &vm->max_pages));
+    if (vm->max_pages > 65536) vm->max_pages = 65536;
+    if (vm->pages > vm->max_pages) return fail(vm, WASM_ERR_MALFORMED, "memory minimum exceeds maximum");
+    return WASM_OK;
+}
+
+static int parse_globals(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    uint32_t count;
+    TRY(read_u32(r, &count));
+    struct wasm_global *globals = xcalloc(vm->nglobals + count, sizeof(struct wasm_global));
+    if (vm->nglobals) memcpy(globals, vm->globals, vm->nglobals * sizeof(struct wasm_global));
+    free(vm->globals);
+    vm->globals = globals;
+    for (uint32_t i = 0; i < count; i++) {
+        struct wasm_global *g = &vm->globals[vm->nglobals];
+        TRY(read_valtype(r, &g->type));
+        TRY(read_u8(r, &g->mutable));
+        TRY(read_const_expr(r, &g->value));
+        vm->nglobals++;
+    }
+    return WASM_OK;
+}
+
+static int parse_exports(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    TRY(read_u32(r, &vm->nexports));
+    vm->exports = xcalloc(vm->nexports, sizeof(struct wasm_export));
+    for (uint32_t i = 0; i < vm->nexports; i++) {
+        struct wasm_export *e = &vm->exports[i];
+        TRY(read_name(r, &e->name));
+        TRY(read_u8(r, &e->kind));
+        TRY(read_u32(r, &e->index));
+    }
+    return WASM_OK;
+}
+
+static int parse_elements(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    TRY(read_u32(r, &vm->nelems));
+    vm->elems = xcalloc(vm->nelems, sizeof(struct wasm_segment));
+    for (uint32_t i = 0; i < vm->nelems; i++) {
+        struct wasm_segment *s = &vm->elems[i];
+        uint32_t flags;
+        uint64_t offset;
+        TRY(read_u32(r, &flags));
+        if (flags != 0) return fail(vm, WASM_ERR_UNSUPPORTED, "element segment kind %u", flags);
+        TRY(read_const_expr(r, &offset));
+        s->offset = (uint32_t)offset;
+        TRY(read_u32(r, &s->size));
+        s->funcs = xcalloc(s->size, sizeof(uint32_t));
+        for (uint32_t j = 0; j < s->size; j++) {
+            TRY(read_u32(r, &s->funcs[j]));
+            if (s->funcs[j] >= vm->nfuncs) return fail(vm, WASM_ERR_MALFORMED, "element function index out of range");
+        }
+    }
+    return WASM_OK;
+}
+
+static int parse_data(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    TRY(read_u32(r, &vm->ndata));
+    vm->data = xcalloc(vm->ndata, sizeof(struct wasm_segment));
+    for (uint32_t i = 0; i < vm->ndata; i++) {
+        struct wasm_segment *s = &vm->data[i];
+        uint32_t flags;
+        uint64_t offset;
+        TRY(read_u32(r, &flags));
+        if (flags != 0) return fail(vm, WASM_ERR_UNSUPPORTED, "passive data segments are not supported by zkWasm");
+        TRY(read_const_expr(r, &offset));
+        s->offset = (uint32_t)offset;
+        TRY(read_u32(r, &s->size));
+        if ((size_t)(r->end - r->p) < s->size) return fail(vm, WASM_ERR_MALFORMED, "data segment out of bounds");
+        s->bytes = r->p;
+        r->p += s->size;
+    }
+    return WASM_OK;
+}
+
+/* Block types: empty, a single value type, or a type index (multi-value) */
+static int read_blocktype(struct reader *r, uint64_t *arity) {
+    uint64_t v;
+    if (r->p < r->end && *r->p == 0x40) {
+        r->p++;
+        *arity = 0;
+        return WASM_OK;
+    }
+    if (r->p < r->end && (*r->p == WASM_I32 || *r->p == WASM_I64)) {
+        r->p++;
+        *arity = 1;
+        return WASM_OK;
+    }
+    TRY(read_leb(r, 33, 1, &v));
+    if ((int64_t)v < 0 || v >= r->vm->ntypes)
+        return fail(r->vm, WASM_ERR_UNSUPPORTED, "unsupported block type");
+    struct wasm_functype *t = &r->vm->types[v];
+    *arity = ((uint64_t)t->nparams << 32) | t->nresults;
+    return WASM_OK;
+}
+
+static int is_supported_opcode(uint8_t op) {
+    if (op <= 0x05 || (op >= 0x0b && op <= 0x11)) return 1;
+    if (op == 0x1a || op == 0x1b) return 1;
+    if (op >= 0x20 && op <= 0x24) return 1;
+    if (op == 0x28 || op == 0x29 || (op >= 0x2c && op <= 0x37) || (op >= 0x3a && op <= 0x42)) return 1;
+    if (op >= 0x45 && op <= 0x5a) return 1;
+    if (op >= 0x67 && op <= 0x8a) return 1;
+    if (op == 0xa7 || op == 0xac || op == 0xad) return 1;
+    if (op >= 0xc0 && op <= 0xc4) return 1;
+    return 0;
+}
+
+/* Instructions behind the 0xfc prefix, all rejected by name */
+static const char *prefix_fc_name(uint32_t op) {
+    static const char *names[] = {
+        "i32.trunc_sat_f32_s", "i32.trunc_sat_f32_u", "i32.trunc_sat_f64_s", "i32.trunc_sat_f64_u",
+        "i64.trunc_sat_f32_s", "i64.trunc_sat_f32_u", "i64.trunc_sat_f64_s", "i64.trunc_sat_f64_u",
+        "memory.init", "data.drop", "memory.copy", "memory.fill",
+        "table.init", "elem.drop", "table.copy", "table.grow", "table.size", "table.fill",
+    };
+    return op < sizeof(names) / sizeof(names[0]) ? names[op] : NULL;
+}
+
+static int decode_body(struct reader *r, struct wasm_func *f) {
+    struct wasm_vm *vm = r->vm;
+    uint32_t capacity = 64, depth = 0;
+    uint32_t control[1024];
+    f->code = xcalloc(capacity, sizeof(struct wasm_instr));
+
+    for (;;) {
+        uint8_t op = 0;
+        TRY(read_u8(r, &op));
+        if (op == 0xfc) {
+            uint32_t sub;
+            TRY(read_u32(r, &sub));
+            const char *name = prefix_fc_name(sub);
+            if (name) return fail(vm, WASM_ERR_UNSUPPORTED, "%s is not supported by zkWasm", name);
+            return fail(vm, WASM_ERR_UNSUPPORTED, "opcode 0xfc %u is not supported by zkWasm", sub);
+        }
+        if (!is_supported_opcode(op))
+            return fail(vm, WASM_ERR_UNSUPPORTED, "opcode 0x%02x is not supported by zkWasm", op);
+
+        if (f->ncode == capacity) {
+            capacity *= 2;
+            f->code = realloc(f->code, capacity * sizeof(struct wasm_instr));
+            if (!f->code) return fail(vm, WASM_ERR_MALFORMED, "out of memory");
+        }
+        uint32_t pc = f->ncode++;
+        struct wasm_instr *ins = &f->code[pc];
+        memset(ins, 0, sizeof(*ins));
+        ins->op = op;
+        ins->rows = 1;
+
+        switch (op) {
+        case 0x01: /* nop */
+            ins->rows = 0;
+            break;
+        case 0x02: /* block */
+        case 0x03: /* loop */
+        case 0x04: /* if */
+            TRY(read_blocktype(r, &ins->imm));
+            if (depth == sizeof(control) / sizeof(control[0]))
+                return fail(vm, WASM_ERR_UNSUPPORTED, "blocks nested too deeply");
+            control[depth++] = pc;
+            /* block and loop are compiled away by zkWasm, if becomes a conditional branch */
+            if (op != 0x04) ins->rows = 0;
+            break;
+        case 0x05: /* else */
+            if (depth == 0 || f->code[control[depth - 1]].op != 0x04)
+                return fail(vm, WASM_ERR_MALFORMED, "else without if");
+            f->code[control[depth - 1]].b = pc;
+            break;
+        case 0x0b: /* end */
+            if (depth == 0) {
+                /* the final end of the body behaves as return */
+                return WASM_OK;
+            }
+            depth--;
+            ins->rows = 0;
+            f->code[control[depth]].a = pc;
+            {
+                struct wasm_instr *open = &f->code[control[depth]];
+                if (open->op == 0x04 && open->b) f->code[open->b].a = pc;
+            }
+            break;
+        case 0x0c: /* br */
+        case 0x0d: /* br_if */
+        case 0x10: /* call */
+        case 0x20: case 0x21: case 0x22: /* local.get/set/tee */
+        case 0x23: case 0x24: /* global.get/set */
+            TRY(read_u32(r, &ins->a));
+            if ((op == 0x0c || op == 0x0d) && ins->a > depth)
+                return fail(vm, WASM_ERR_MALFORMED, "branch depth out of range");
+            if (op == 0x10 && ins->a >= vm->nfuncs)
+                return fail(vm, WASM_ERR_MALFORMED, "call target out of range");
+            if ((op == 0x23 || op == 0x24) && ins->a >= vm->nglobals)
+                return fail(vm, WASM_ERR_MALFORMED, "global index out of range");
+            break;
+        case 0x0e: { /* br_table */
+            uint32_t n;
+            TRY(read_u32(r, &n));
+            ins->a = vm->nbr_targets;
+            ins->b = n + 1;
+            vm->br_targets = realloc(vm->br_targets, (vm->nbr_targets + n + 1) * sizeof(uint32_t));
+            for (uint32_t i = 0; i <= n; i++) {
+                uint32_t target;
+                TRY(read_u32(r, &target));
+                if (target > depth) return fail(vm, WASM_ERR_MALFORMED, "branch depth out of range");
+                vm->br_targets[vm->nbr_targets++] = target;
+            }
+            break;
+        }
+        case 0x11: { /* call_indirect */
+            uint8_t table = 0;
+            TRY(read_u32(r, &ins->a));
+            TRY(read_u8(r, &table));
+            if (ins->a >= vm->ntypes || table != 0)
+                return fail(vm, WASM_ERR_MALFORMED, "bad call_indirect immediate");
+            break;
+        }
+        case 0x1b: /* select */
+            break;
+        case 0x3f: /* memory.size */
+        case 0x40: { /* memory.grow */
+            uint8_t zero;
+            TRY(read_u8(r, &zero));
+            break;
+        }
+        case 0x41:
+            TRY(read_leb(r, 32, 1, &ins->imm));
+            ins->imm = (uint32_t)ins->imm;
+            break;
+        case 0x42:
+            TRY(read_leb(r, 64, 1, &ins->imm));
+            break;
+        default:
+            if (op >= 0x28 && op <= 0x3e) {
+                /* memarg: alignment hint then offset */
+                TRY(read_u32(r, &ins->b));
+                TRY(read_u32(r, &ins->a));
+            }
+            break;
+        }
+    }
+}
+
+static int parse_code(struct reader *r) {
+    struct wasm_vm *vm = r->vm;
+    uint32_t count;
+    TRY(read_u32(r, &count));
+    if (count != vm->nfuncs - vm->nimports) return fail(vm, WASM_ERR_MALFORMED, "function and code counts differ");
+    for (uint32_t i = 0; i < count; i++) {
+        struct wasm_func *f = &vm->funcs[vm->nimports + i];
+        uint32_t size, groups;
+        TRY(read_u32(r, &size));
+        if ((size_t)(r->end - r->p) < size) return fail(vm, WASM_ERR_MALFORMED, "function body out of bounds");
+        struct reader body = { r->p, r->p + size, vm };
+        r->p += size;
+
+        TRY(read_u32(&body, &groups));
+        for (uint32_t g = 0; g < groups; g++) {
+            uint32_t n;
+            uint8_t type;
+            TRY(read_u32(&body, &n));
+            TRY(read_valtype(&body, &type));
+            if ((uint64_t)f->nlocals + n > WASM_VALUE_STACK / 4) return fail(vm, WASM_ERR_UNSUPPORTED, "too many locals");
+            f->nlocals += n;
+        }
+        TRY(decode_body(&body, f));
+    }
+    return WASM_OK;
+}
+
+/*
+ * Function names from the symbol table of the "linking" section, which
+ * relocatable objects carry in place of a name section.
+ */
+static int parse_linking(struct reader *r) {
+    uint32_t version;
+    TRY(read_u32(r, &version));
+    if (version != 2) return WASM_OK;
+
+    while (r->p < r->end) {
+        uint8_t id;
+        uint32_t size, count;
+        TRY(read_u8(r, &id));
+        TRY(read_u32(r, &size));
+        if ((size_t)(r->end - r->p) < size) return WASM_OK;
+        struct reader sub = { r->p, r->p + size, r->vm };
+        r->p += size;
+        /* 8: symbol table */
+        if (id != 8) continue;
+
+        TRY(read_u32(&sub, &count));
+        for (uint32_t i = 0; i < count; i++) {
+            uint8_t kind;
+            uint32_t flags, index, unused;
+            char *name = NULL;
+            TRY(read_u8(&sub, &kind));
+            TRY(read_u32(&sub, &flags));
+            if (kind == 1) {
+                /* data: name, then segment, offset and size when defined */
+                TRY(read_name(&sub, &name));
+                free(name);
+                if (!(flags & 0x10)) {
+                    for (int j = 0; j < 3; j++) TRY(read_u32(&sub, &unused));
+                }
+                continue;
+            }
+            TRY(read_u32(&sub, &index));
+            /* section symbols have no name, undefined ones only an explicit one (0x40) */
+            if (kind == 3 || ((flags & 0x10) && !(flags & 0x40))) continue;
+            TRY(read_name(&sub, &name));
+            if (kind == 0 && index < r->vm->nfuncs && !r->vm->funcs[index].name) {
+                r->vm->funcs[index].name = name;
+                continue;
+            }
+            free(name);
+        }
+    }
+    return WASM_OK;
+}
+
+/* Function names from the "name" custom section, absent after --strip-all */
+static int parse_names(struct reader *r) {
+    char *section;
+    TRY(read_name(r, &section));
+    int is_name = strcmp(section, "name") == 0;
+    int is_linking = strcmp(section, "linking") == 0;
+    free(section);
+    if (is_linking) return parse_linking(r);
+    if (!is_name) return WASM_OK;
+
+    while (r->p < r->end) {
+        uint8_t id;
+        uint32_t size;
+        TRY(read_u8(r, &id));
+        TRY(read_u32(r, &size));
+        if ((size_t)(r->end - r->p) < size) return WASM_OK;
+        struct reader sub = { r->p, r->p + size, r->vm };
+        r->p += size;
+        /* 1: function names, 7: global names */
+        if (id != 1 && id != 7) continue;
+
+        uint32_t count;
+        TRY(read_u32(&sub, &count));
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t index;
+            char *name;
+            TRY(read_u32(&sub, &index));
+            TRY(read_name(&sub, &name));
+            if (id == 1 && index < r->vm->nfuncs && !r->vm->funcs[index].name) {
+                r->vm->funcs[index].name = name;
+                continue;
+            }
+            if (id == 7 && strcmp(name, "__stack_pointer") == 0) r->vm->stack_global = (int32_t)index;
+            free(name);
+        }
+    }
+    return WASM_OK;
+}
+
+static int load(struct wasm_vm *vm, const uint8_t *bytes, size_t size, uint8_t static_only) {
+    static const uint8_t magic[8] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    struct reader r = { bytes, bytes + size, vm };
+
+    memset(vm, 0, sizeof(*vm));
+    vm->static_only = static_only;
+    vm->start = -1;
+    vm->stack_global = -1;
+    if (size < 8 || memcmp(bytes, magic, 8) != 0) return fail(vm, WASM_ERR_MALFORMED, "not a wasm module");
+    r.p += 8;
+
+    while (r.p < r.end) {
+        uint8_t id;
+        uint32_t len;
+        TRY(read_u8(&r, &id));
+        TRY(read_u32(&r, &len));
+        if ((size_t)(r.end - r.p) < len) return fail(vm, WASM_ERR_MALFORMED, "section out of bounds");
+        struct reader s = { r.p, r.p + len, vm };
+        r.p += len;
+
+        switch (id) {
+        case 0: TRY(parse_names(&s)); break;
+        case 1: TRY(parse_types(&s)); break;
+        case 2: TRY(parse_imports(&s)); break;
+        case 3: TRY(parse_functions(&s)); break;
+        case 4: TRY(parse_table(&s)); break;
+        case 5: TRY(parse_memory(&s)); break;
+        case 6: TRY(parse_globals(&s)); break;
+        case 7: TRY(parse_exports(&s)); break;
+        case 8: {
+            uint32_t start;
+            TRY(read_u32(&s, &start));
+            vm->start = (int32_t)start;
+            break;
+        }
+        case 9: TRY(parse_elements(&s)); break;
+        case 10: TRY(parse_code(&s)); break;
+        case 11: TRY(parse_data(&s)); break;
+        case 12: break;
+        default:
+            return fail(vm, WASM_ERR_UNSUPPORTED, "unknown section %u", id);
+        }
+    }
+    return WASM_OK;
+}
+
+int wasm_load(struct wasm_vm *vm, const uint8_t *bytes, size_t size) {
+    return load(vm, bytes, size, 0);
+}
+
+/* Loads a module for inspection only, see wasm_vm.static_only */
+int wasm_load_static(struct wasm_vm *vm, const uint8_t *bytes, size_t size) {
+    return load(vm, bytes, size, 1);
+}
+
+int wasm_instantiate(struct wasm_vm *vm) {
+    if (vm->static_only) return fail(vm, WASM_ERR_LINK, "module was loaded for static analysis only");
+    for (uint32_t i = 0; i < vm->nimports; i++) {
+        if (!vm->funcs[i].host)
+            return fail(vm, WASM_ERR_LINK, "unresolved import %s.%s", vm->funcs[i].module, vm->funcs[i].field);
+    }
+
+    vm->memory = xcalloc((size_t)vm->pages * WASM_PAGE_SIZE, 1);
+    for (uint32_t i = 0; i < vm->ndata; i++) {
+        struct wasm_segment *s = &vm->data[i];
+        if ((uint64_t)s->offset + s->size > (uint64_t)vm->pages * WASM_PAGE_SIZE)
+            return fail(vm, WASM_ERR_LINK, "data segment %u does not fit in memory", i);
+        memcpy(vm->memory + s->offset, s->bytes, s->size);
+    }
+    for (uint32_t i = 0; i < vm->nelems; i++) {
+        struct wasm_segment *s = &vm->elems[i];
+        if ((uint64_t)s->offset + s->size > vm->ntable)
+            return fail(vm, WASM_ERR_LINK, "element segment %u does not fit in table", i);
+        memcpy(vm->table + s->offset, s->funcs, s->size * sizeof(uint32_t));
+    }
+
+    /* wasm-ld defines __stack_pointer first; stripped images lose its name */
+    if (vm->stack_global < 0 && vm->nglobals && vm->globals[0].mutable && vm->globals[0].type == WASM_I32)
+        vm->stack_global = 0;
+    if (vm->stack_global >= (int32_t)vm->nglobals) vm->stack_global = -1;
+    if (vm->stack_global >= 0) {
+        vm->stack_base = (uint32_t)vm->globals[vm->stack_global].value;
+        vm->stack_low = vm->stack_base;
+    }
+
+    /* the linker only exports the layout symbols on request, fall back to the segments */
+    vm->data_end = 0;
+    for (uint32_t i = 0; i < vm->ndata; i++) {
+        if (vm->data[i].offset + vm->data[i].size > vm->data_end)
+            vm->data_end = vm->data[i].offset + vm->data[i].size;
+    }
+    vm->heap_base = vm->stack_base > vm->data_end ? vm->stack_base : vm->data_end;
+    int g = wasm_find_export(vm, "__data_end", 3);
+    if (g >= 0 && (uint32_t)g < vm->nglobals) vm->data_end = (uint32_t)vm->globals[g].value;
+    g = wasm_find_export(vm, "__heap_base", 3);
+    if (g >= 0 && (uint32_t)g < vm->nglobals) vm->heap_base = (uint32_t)vm->globals[g].value;
+    vm->store_high = 0;
+
+    vm->stack = xcalloc(WASM_VALUE_STACK, sizeof(uint64_t));
+    vm->labels = xcalloc(WASM_LABEL_STACK, sizeof(struct wasm_label));
+    vm->frames = xcalloc(WASM_CALL_DEPTH, sizeof(struct wasm_frame));
+
+    if (vm->start >= 0) {
+        if ((uint32_t)vm->start >= vm->nfuncs) return fail(vm, WASM_ERR_MALFORMED, "start function out of range");
+        return wasm_invoke(vm, vm->start, NULL, NULL);
+    }
+    return WASM_OK;
+}
+
+void wasm_free(struct wasm_vm *vm) {
+    for (uint32_t i = 0; i < vm->nfuncs; i++) {
+        free(vm->funcs[i].name);
+        free(vm->funcs[i].module);
+        free(vm->funcs[i].field);
+        free(vm->funcs[i].code);
+    }
+    for (uint32_t i = 0; i < vm->nexports; i++) free(vm->exports[i].name);
+    for (uint32_t i = 0; i < vm->nelems; i++) free(vm->elems[i].funcs);
+    free(vm->funcs);
+    free(vm->types);
+    free(vm->table);
+    free(vm->memory);
+    free(vm->globals);
+    free(vm->exports);
+    free(vm->data);
+    free(vm->elems);
+    free(vm->br_targets);
+    free(vm->stack);
+    free(vm->labels);
+    free(vm->frames);
+    memset(vm, 0, sizeof(*vm));
+}
+
+int wasm_find_export(struct wasm_vm *vm, const char *name, uint8_t kind) {
+    for (uint32_t i = 0; i < vm->nexports; i++) {
+        if (vm->exports[i].kind == kind && strcmp(vm->exports[i].name, name) == 0)
+            return (int)vm->exports[i].index;
+    }
+    return -1;
+}
+
+const char *wasm_func_name(struct wasm_vm *vm, uint32_t func) {
+    static char buf[32];
+    if (func >= vm->nfuncs) return "?";
+    if (vm->funcs[func].name) return vm->funcs[func].name;
+    if (vm->funcs[func].field) return vm->funcs[func].field;
+    for (uint32_t i = 0; i < vm->nexports; i++) {
+        if (vm->exports[i].kind == 0 && vm->exports[i].index == func) return vm->exports[i].name;
+    }
+    snprintf(buf, sizeof(buf), "func[%u]", func);
+    return buf;
+}
+
+static int same_type(const struct wasm_functype *a, const struct wasm_functype *b) {
+    return a->nparams == b->nparams && a->nresults == b->nresults
+        && memcmp(a->params, b->params, a->nparams) == 0
+        && memcmp(a->results, b->results, a->nresults) == 0;
+}
+
+#define I32(v) ((uint32_t)(v))
+#define S32(v) ((int32_t)(uint32_t)(v))
+#define S64(v) ((int64_t)(v))
+
+#define BINOP32(expr) { uint32_t y = I32(stack[--sp]), x = I32(stack[sp - 1]); (void)x; (void)y; stack[sp - 1] = (uint32_t)(expr); break; }
+#define BINOP64(expr) { uint64_t y = stack[--sp], x = stack[sp - 1]; (void)x; (void)y; stack[sp - 1] = (uint64_t)(expr); break; }
+#define UNOP32(expr) { uint32_t x = I32(stack[sp - 1]); stack[sp - 1] = (uint32_t)(expr); break; }
+#define UNOP64(expr) { uint64_t x = stack[sp - 1]; stack[sp - 1] = (uint64_t)(expr); break; }
+
+#define EFFECTIVE(size)                                                              \
+    uint64_t ea = (uint64_t)I32(stack[sp - 1]) + ins->a;                             \
+    if (ea + (size) > (uint64_t)vm->pages * WASM_PAGE_SIZE) {                        \
+        err = wasm_trap(vm, "out of bounds memory access at 0x%llx", (unsigned long long)ea); \
+        goto out;                                                                    \
+    }                                                                                \
+    uint8_t *addr = vm->memory + ea;
+
+#define LOAD(type, size, conv) { EFFECTIVE(size); type v; memcpy(&v, addr, size); stack[sp - 1] = conv; break; }
+
+#define STORE(size) {                                                                \
+    uint64_t value = stack[--sp];                                                    \
+    EFFECTIVE(size);                                                                 \
+    memcpy(addr, &value, size);                                                      \
+    if (ea + (size) > vm->store_high) vm->store_high = ea + (size);                  \
+    sp--;                                                                            \
+    break;                                                                           \
+}
+
+static inline void branch_values(uint64_t *stack, uint32_t *sp, uint32_t height, uint32_t arity) {
+    if (*sp - arity != height) memmove(&stack[height], &stack[*sp - arity], arity * sizeof(uint64_t));
+    *sp = height + arity;
+}
+
+/*
+ * Runs `entry` whose arguments are already on the value stack. Returns when
+ * the call depth drops back to where it started.
+ */
+static int execute(struct wasm_vm *vm, uint32_t entry, uint32_t *psp) {
+    uint64_t *stack = vm->stack;
+    struct wasm_label *labels = vm->labels;
+    struct wasm_frame *frames = vm->frames;
+    uint32_t sp = *psp, lp = 0, fp = 0, pc = 0;
+    uint32_t base_depth = vm->depth;
+    struct wasm_func *f = NULL;
+    struct wasm_instr *code = NULL;
+    int err = WASM_OK;
+    uint32_t callee = entry;
+
+call:
+    {
+        struct wasm_func *g = &vm->funcs[callee];
+        struct wasm_functype *t = &vm->types[g->type];
+        g->calls++;
+        if (vm->tracer.enter) vm->tracer.enter(vm, callee);
+        if (g->host) {
+            uint64_t result = 0;
+            sp -= t->nparams;
+            err = g->host(vm, &stack[sp], &result);
+            if (vm->tracer.leave) vm->tracer.leave(vm, callee);
+            if (err) goto out;
+            if (t->nresults) stack[sp++] = t->results[0] == WASM_I32 ? I32(result) : result;
+            if (vm->depth == base_depth) goto done;
+            goto next;
+        }
+        if (vm->depth == WASM_CALL_DEPTH || (uint64_t)sp + g->nlocals + g->ncode >= WASM_VALUE_STACK
+            || lp + g->ncode + 1 >= WASM_LABEL_STACK) {
+            err = wasm_trap(vm, "call stack exhausted");
+            goto out;
+        }
+        if (vm->depth > base_depth) frames[vm->depth - 1].pc = pc;
+        fp = sp - t->nparams;
+        memset(&stack[sp], 0, g->nlocals * sizeof(uint64_t));
+        sp += g->nlocals;
+        frames[vm->depth].func = callee;
+        frames[vm->depth].fp = fp;
+        frames[vm->depth].label_base = lp;
+        vm->depth++;
+        /* the function body is the outermost label */
+        labels[lp].pc = g->ncode;
+        labels[lp].height = sp;
+        labels[lp].arity = t->nresults;
+        lp++;
+        f = g;
+        code = g->code;
+        pc = 0;
+    }
+
+next:
+    for (;;) {
+        struct wasm_instr *ins = &code[pc++];
+        vm->instructions += ins->rows;
+
+        switch (ins->op) {
+        case 0x00:
+            err = wasm_trap(vm, "unreachable executed");
+            goto out;
+        case 0x01:
+            break;
+        case 0x02: /* block */
+        case 0x03: { /* loop */
+            uint32_t params = (uint32_t)(ins->imm >> 32);
+            labels[lp].height = sp - params;
+            if (ins->op == 0x03) {
+                labels[lp].pc = pc;
+                labels[lp].arity = params;
+            } else {
+                labels[lp].pc = ins->a + 1;
+                labels[lp].arity = (uint32_t)ins->imm;
+            }
+            lp++;
+            break;
+        }
+        case 0x04: { /* if */
+            uint32_t cond = I32(stack[--sp]);
+            uint32_t params = (uint32_t)(ins->imm >> 32);
+            if (cond || ins->b) {
+                labels[lp].height = sp - params;
+                labels[lp].pc = ins->a + 1;
+                labels[lp].arity = (uint32_t)ins->imm;
+                lp++;
+                if (!cond) pc = ins->b + 1;
+            } else {
+                pc = ins->a + 1;
+            }
+            break;
+        }
+        case 0x05: /* else reached from the then arm: leave the if */
+            pc = ins->a;
+            break;
+        case 0x0b: /* end */
+            lp--;
+            if (lp == frames[vm->depth - 1].label_base) goto ret;
+            break;
+        case 0x0c: /* br */
+        case 0x0d: /* br_if */
+        case 0x0e: { /* br_table */
+            uint32_t depth = ins->a;
+            if (ins->op == 0x0d) {
+                if (!I32(stack[--sp])) break;
+            } else if (ins->op == 0x0e) {
+                uint32_t i = I32(stack[--sp]);
+                if (i >= ins->b - 1) i = ins->b - 1;
+                depth = vm->br_targets[ins->a + i];
+            }
+            uint32_t target = lp - 1 - depth;
+            struct wasm_label *l = &labels[target];
+            branch_values(stack, &sp, l->height, l->arity);
+            if (target == frames[vm->depth - 1].label_base) goto ret;
+            pc = l->pc;
+            /* a loop label stays live across its backward branch */
+            lp = code[pc - 1].op == 0x03 ? target + 1 : target;
+            break;
+        }
+        case 0x0f: /* return */
+            goto ret;
+        case 0x10: /* call */
+            callee = ins->a;
+            goto call;
+        case 0x11: { /* call_indirect */
+            uint32_t i = I32(stack[--sp]);
+            if (i >= vm->ntable || vm->table[i] == UINT32_MAX) {
+                err = wasm_trap(vm, "undefined table element %u", i);
+                goto out;
+            }
+            callee = vm->table[i];
+            if (!same_type(&vm->types[vm->funcs[callee].type], &vm->types[ins->a])) {
+                err = wasm_trap(vm, "indirect call signature mismatch");
+                goto out;
+            }
+            goto call;
+        }
+        case 0x1a:
+            sp--;
+            break;
+        case 0x1b: {
+            uint32_t c = I32(stack[--sp]);
+            sp--;
+            if (!c) stack[sp - 1] = stack[sp];
+            break;
+        }
+        case 0x20:
+            stack[sp++] = stack[fp + ins->a];
+            break;
+        case 0x21:
+            stack[fp + ins->a] = stack[--sp];
+            break;
+        case 0x22:
+            stack[fp + ins->a] = stack[sp - 1];
+            break;
+        case 0x23:
+            stack[sp++] = vm->globals[ins->a].value;
+            break;
+        case 0x24:
+            vm->globals[ins->a].value = stack[--sp];
+            /* signed, so that a stack running past address 0 still counts as lower */
+            if ((int32_t)ins->a == vm->stack_global && (int32_t)I32(stack[sp]) < (int32_t)vm->stack_low) {
+                vm->stack_low = I32(stack[sp]);
+                /* catch the stack before it runs into the statics below it */
+                if ((int32_t)vm->stack_low < (int32_t)vm->data_end && vm->stack_base > vm->data_end) {
+                    err = wasm_trap(vm, "stack overflow: __stack_pointer %d is below the end of static data %u",
+                                    (int32_t)vm->stack_low, vm->data_end);
+                    goto out;
+                }
+            }
+            break;
+
+        case 0x28: LOAD(uint32_t, 4, v)
+        case 0x29: LOAD(uint64_t, 8, v)
+        case 0x2c: LOAD(int8_t, 1, (uint32_t)(int32_t)v)
+        case 0x2d: LOAD(uint8_t, 1, (uint32_t)v)
+        case 0x2e: LOAD(int16_t, 2, (uint32_t)(int32_t)v)
+        case 0x2f: LOAD(uint16_t, 2, (uint32_t)v)
+        case 0x30: LOAD(int8_t, 1, (uint64_t)(int64_t)v)
+        case 0x31: LOAD(uint8_t, 1, (uint64_t)v)
+        case 0x32: LOAD(int16_t, 2, (uint64_t)(int64_t)v)
+        case 0x33: LOAD(uint16_t, 2, (uint64_t)v)
+        case 0x34: LOAD(int32_t, 4, (uint64_t)(int64_t)v)
+        case 0x35: LOAD(uint32_t, 4, (uint64_t)v)
+        case 0x36: STORE(4)
+        case 0x37: STORE(8)
+        case 0x3a: STORE(1)
+        case 0x3b: STORE(2)
+        case 0x3c: STORE(1)
+        case 0x3d: STORE(2)
+        case 0x3e: STORE(4)
+
+        case 0x3f:
+            stack[sp++] = vm->pages;
+            break;
+        case 0x40: {
+            uint32_t delta = I32(stack[sp - 1]);
+            uint32_t old = vm->pages;
+            if ((uint64_t)old + delta > vm->max_pages) {
+                stack[sp - 1] = UINT32_MAX;
+                break;
+            }
+            if (delta) {
+                uint8_t *memory = realloc(vm->memory, (size_t)(old + delta) * WASM_PAGE_SIZE);
+                if (!memory) {
+                    stack[sp - 1] = UINT32_MAX;
+                    break;
+                }
+                memset(memory + (size_t)old * WASM_PAGE_SIZE, 0, (size_t)delta * WASM_PAGE_SIZE);
+                vm->memory = memory;
+                vm->pages = old + delta;
+            }
+            stack[sp - 1] = old;
+            break;
+        }
+        case 0x41:
+        case 0x42:
+            stack[sp++] = ins->imm;
+            break;
+
+        case 0x45: UNOP32(x == 0)
+        case 0x46: BINOP32(x == y)
+        case 0x47: BINOP32(x != y)
+        case 0x48: BINOP32((int32_t)x < (int32_t)y)
+        case 0x49: BINOP32(x < y)
+        case 0x4a: BINOP32((int32_t)x > (int32_t)y)
+        case 0x4b: BINOP32(x > y)
+        case 0x4c: BINOP32((int32_t)x <= (int32_t)y)
+        case 0x4d: BINOP32(x <= y)
+        case 0x4e: BINOP32((int32_t)x >= (int32_t)y)
+        case 0x4f: BINOP32(x >= y)
+        case 0x50: UNOP64(x == 0)
+        case 0x51: BINOP64(x == y)
+        case 0x52: BINOP64(x != y)
+        case 0x53: BINOP64(S64(x) < S64(y))
+        case 0x54: BINOP64(x < y)
+        case 0x55: BINOP64(S64(x) > S64(y))
+        case 0x56: BINOP64(x > y)
+        case 0x57: BINOP64(S64(x) <= S64(y))
+        case 0x58: BINOP64(x <= y)
+        case 0x59: BINOP64(S64(x) >= S64(y))
+        case 0x5a: BINOP64(x >= y)
+
+        case 0x67: UNOP32(x ? __builtin_clz(x) : 32)
+        case 0x68: UNOP32(x ? __builtin_ctz(x) : 32)
+        case 0x69: UNOP32(__builtin_popcount(x))
+        case 0x6a: BINOP32(x + y)
+        case 0x6b: BINOP32(x - y)
+        case 0x6c: BINOP32(x * y)
+        case 0x6d:
+        case 0x6e:
+        case 0x6f:
+        case 0x70: {
+            uint32_t y = I32(stack[--sp]), x = I32(stack[sp - 1]);
+            if (y == 0) {
+                err = wasm_trap(vm, "integer divide by zero");
+                goto out;
+            }
+            if (ins->op == 0x6d) {
+                if (x == 0x80000000u && y == 0xffffffffu) {
+                    err = wasm_trap(vm, "integer overflow");
+                    goto out;
+                }
+                stack[sp - 1] = (uint32_t)((int32_t)x / (int32_t)y);
+            } else if (ins->op == 0x6e) {
+                stack[sp - 1] = x / y;
+            } else if (ins->op == 0x6f) {
+                stack[sp - 1] = y == 0xffffffffu ? 0 : (uint32_t)((int32_t)x % (int32_t)y);
+            } else {
+                stack[sp - 1] = x % y;
+            }
+            break;
+        }
+        case 0x71: BINOP32(x & y)
+        case 0x72: BINOP32(x | y)
+        case 0x73: BINOP32(x ^ y)
+        case 0x74: BINOP32(x << (y & 31))
+        case 0x75: BINOP32((int32_t)x >> (y & 31))
+        case 0x76: BINOP32(x >> (y & 31))
+        case 0x77: BINOP32((x << (y & 31)) | (x >> ((32 - (y & 31)) & 31)))
+        case 0x78: BINOP32((x >> (y & 31)) | (x << ((32 - (y & 31)) & 31)))
+
+        case 0x79: UNOP64(x ? __builtin_clzll(x) : 64)
+        case 0x7a: UNOP64(x ? __builtin_ctzll(x) : 64)
+        case 0x7b: UNOP64(__builtin_popcountll(x))
+        case 0x7c: BINOP64(x + y)
+        case 0x7d: BINOP64(x - y)
+        case 0x7e: BINOP64(x * y)
+        case 0x7f:
+        case 0x80:
+        case 0x81:
+        case 0x82: {
+            uint64_t y = stack[--sp], x = stack[sp - 1];
+            if (y == 0) {
+                err = wasm_trap(vm, "integer divide by zero");
+                goto out;
+            }
+            if (ins->op == 0x7f) {
+                if (x == 0x8000000000000000ull && y == ~0ull) {
+                    err = wasm_trap(vm, "integer overflow");
+                    goto out;
+                }
+                stack[sp - 1] = (uint64_t)(S64(x) / S64(y));
+            } else if (ins->op == 0x80) {
+                stack[sp - 1] = x / y;
+            } else if (ins->op == 0x81) {
+                stack[sp - 1] = y == ~0ull ? 0 : (uint64_t)(S64(x) % S64(y));
+            } else {
+                stack[sp - 1] = x % y;
+            }
+            break;
+        }
+        case 0x83: BINOP64(x & y)
+        case 0x84: BINOP64(x | y)
+        case 0x85: BINOP64(x ^ y)
+        case 0x86: BINOP64(x << (y & 63))
+        case 0x87: BINOP64(S64(x) >> (y & 63))
+        case 0x88: BINOP64(x >> (y & 63))
+        case 0x89: BINOP64((x << (y & 63)) | (x >> ((64 - (y & 63)) & 63)))
+        case 0x8a: BINOP64((x >> (y & 63)) | (x << ((64 - (y & 63)) & 63)))
+
+        case 0xa7: UNOP64((uint32_t)x)
+        case 0xac: UNOP64((uint64_t)(int64_t)(int32_t)(uint32_t)x)
+        case 0xad: UNOP64((uint32_t)x)
+        case 0xc0: UNOP32((uint32_t)(int32_t)(int8_t)x)
+        case 0xc1: UNOP32((uint32_t)(int32_t)(int16_t)x)
+        case 0xc2: UNOP64((uint64_t)(int64_t)(int8_t)x)
+        case 0xc3: UNOP64((uint64_t)(int64_t)(int16_t)x)
+        case 0xc4: UNOP64((uint64_t)(int64_t)(int32_t)x)
+
+        default:
+            err = wasm_trap(vm, "invalid opcode 0x%02x", ins->op);
+            goto out;
+        }
+        continue;
+
+ret:
+        {
+            struct wasm_frame *frame = &frames[--vm->depth];
+            uint32_t nresults = vm->types[f->type].nresults;
+            branch_values(stack, &sp, frame->fp, nresults);
+            lp = frame->label_base;
+            if (vm->tracer.leave) vm->tracer.leave(vm, frame->func);
+            if (vm->depth == base_depth) goto done;
+            struct wasm_frame *caller = &frames[vm->depth - 1];
+            f = &vm->funcs[caller->func];
+            code = f->code;
+            pc = caller->pc;
+            fp = caller->fp;
+        }
+    }
+
+done:
+    *psp = sp;
+    return WASM_OK;
+out:
+    return err;
+}
+
+int wasm_invoke(struct wasm_vm *vm, uint32_t func, const uint64_t *args, uint64_t *results) {
+    struct wasm_functype *t = &vm->types[vm->funcs[func].type];
+    uint32_t sp = 0;
+    int err;
+
+    if (vm->depth) return fail(vm, WASM_ERR_TRAP, "re-entrant invocation");
+    for (uint32_t i = 0; i < t->nparams; i++) vm->stack[sp++] = args[i];
+    err = execute(vm, func, &sp);
+    if (err) return err;
+    for (uint32_t i = 0; i < t->nresults; i++) {
+        if (results) results[i] = vm->stack[i];
+    }
+    return WASM_OK;
+}
@@ -0,0 +1,183 @@
+#ifndef __ZKRUN_WASM__
+
+#define __ZKRUN_WASM__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define WASM_PAGE_SIZE 65536
+
+#define WASM_I32 0x7f
+#define WASM_I64 0x7e
+
+#define WASM_MAX_PARAMS 16
+#define WASM_VALUE_STACK (1 << 20)
+#define WASM_LABEL_STACK (1 << 16)
+#define WASM_CALL_DEPTH (1 << 14)
+
+#define WASM_OK 0
+#define WASM_ERR_MALFORMED -1
+#define WASM_ERR_UNSUPPORTED -2
+#define WASM_ERR_LINK -3
+#define WASM_ERR_TRAP -4
+
+struct wasm_vm;
+
+/*
+ * Host functions receive their arguments as raw 64-bit slots and write at
+ * most one result. A non-zero return value traps the guest.
+ */
+typedef int (*wasm_host_fn)(struct wasm_vm *vm, const uint64_t *args, uint64_t *result);
+
+struct wasm_functype {
+    uint32_t nparams;
+    uint32_t nresults;
+    uint8_t params[WASM_MAX_PARAMS];
+    uint8_t results[WASM_MAX_PARAMS];
+};
+
+/*
+ * Pre-decoded instruction. Structured control instructions carry the index
+ * of their matching else/end so that branches never rescan the bytecode.
+ */
+struct wasm_instr {
+    uint16_t op;
+    /* trace rows charged when the instruction executes */
+    uint8_t rows;
+    uint32_t a;
+    uint32_t b;
+    uint64_t imm;
+};
+
+struct wasm_func {
+    uint32_t type;
+    char *name;
+    /* imports */
+    char *module;
+    char *field;
+    wasm_host_fn host;
+    /* definitions */
+    uint32_t nlocals;
+    struct wasm_instr *code;
+    uint32_t ncode;
+    /* number of times the function was entered */
+    uint64_t calls;
+};
+
+struct wasm_global {
+    uint8_t type;
+    uint8_t mutable;
+    uint64_t value;
+};
+
+struct wasm_segment {
+    uint32_t offset;
+    uint32_t size;
+    const uint8_t *bytes;
+    uint32_t *funcs;
+};
+
+struct wasm_export {
+    char *name;
+    uint8_t kind;
+    uint32_t index;
+};
+
+struct wasm_label {
+    uint32_t pc;
+    uint32_t height;
+    uint32_t arity;
+};
+
+struct wasm_frame {
+    uint32_t func;
+    uint32_t pc;
+    uint32_t fp;
+    uint32_t label_base;
+};
+
+/* Observer invoked on every call/return, used by profiling modes */
+struct wasm_tracer {
+    void (*enter)(struct wasm_vm *vm, uint32_t func);
+    void (*leave)(struct wasm_vm *vm, uint32_t func);
+    void *data;
+};
+
+struct wasm_vm {
+    struct wasm_functype *types;
+    uint32_t ntypes;
+
+    struct wasm_func *funcs;
+    uint32_t nfuncs;
+    uint32_t nimports;
+
+    uint32_t *table;
+    uint32_t ntable;
+
+    uint8_t *memory;
+    uint32_t pages;
+    uint32_t max_pages;
+
+    struct wasm_global *globals;
+    uint32_t nglobals;
+
+    struct wasm_export *exports;
+    uint32_t nexports;
+
+    struct wasm_segment *data;
+    uint32_t ndata;
+
+    struct wasm_segment *elems;
+    uint32_t nelems;
+
+    uint32_t *br_targets;
+    uint32_t nbr_targets;
+
+    int32_t start;
+
+    /*
+     * Set by wasm_load_static: memory, table and global imports (as in the
+     * relocatable sdk objects) are accepted and the module cannot run.
+     */
+    uint8_t static_only;
+
+    /* __stack_pointer, its value at instantiation and the lowest value seen */
+    int32_t stack_global;
+    uint32_t stack_base;
+    uint32_t stack_low;
+
+    /*
+     * Memory layout: end of static data (__data_end), start of the heap
+     * (__heap_base) and the highest address written so far. wasm-ld places
+     * the stack between the two, growing down towards __data_end.
+     */
+    uint32_t data_end;
+    uint32_t heap_base;
+    uint64_t store_high;
+
+    /* execution state */
+    uint64_t *stack;
+    struct wasm_label *labels;
+    struct wasm_frame *frames;
+    uint32_t depth;
+
+    /* executed instructions, our proxy for zkWasm trace rows */
+    uint64_t instructions;
+
+    struct wasm_tracer tracer;
+    void *host_data;
+    char error[256];
+};
+
+int wasm_load(struct wasm_vm *vm, const uint8_t *bytes, size_t size);
+int wasm_load_static(struct wasm_vm *vm, const uint8_t *bytes, size_t size);
+int wasm_instantiate(struct wasm_vm *vm);
+void wasm_free(struct wasm_vm *vm);
+
+int wasm_find_export(struct wasm_vm *vm, const char *name, uint8_t kind);
+const char *wasm_func_name(struct wasm_vm *vm, uint32_t func);
+
+int wasm_invoke(struct wasm_vm *vm, uint32_t func, const uint64_t *args, uint64_t *results);
+int wasm_trap(struct wasm_vm *vm, const char *fmt, ...);
+
+#endif